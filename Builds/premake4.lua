@@ -37,6 +37,21 @@ else
 	print "Action not specified\n"
 end
 
+newoption {
+	trigger = "realtime-audit",
+	description = "Report allocations, locks and system calls on the audio thread (debug builds of stand-alone, analyser and benchmark only)"
+}
+
+-- the real-time audit replaces malloc() and friends, so it may only be
+-- compiled into executables and never into plug-ins loaded by a host
+function realtime_audit()
+	if _OPTIONS["realtime-audit"] then
+		configuration "Debug"
+			defines { "TRAKMETER_REALTIME_AUDIT=1" }
+			linkoptions { "-rdynamic" }
+	end
+end
+
 solution "trakmeter"
 	language "C++"
 
@@ -132,6 +147,8 @@ solution "trakmeter"
 				"/usr/include/freetype2"
 			}
 
+		realtime_audit()
+
 		configuration "Debug"
 			objdir ("../bin/intermediate_" .. os.get() .. "/standalone_stereo_debug")
 
@@ -179,12 +196,146 @@ solution "trakmeter"
 				"/usr/include/freetype2"
 			}
 
+		realtime_audit()
+
 		configuration "Debug"
 			objdir ("../bin/intermediate_" .. os.get() .. "/standalone_multi_debug")
 
 		configuration "Release"
 			objdir ("../bin/intermediate_" .. os.get() .. "/standalone_multi_release")
 
+--------------------------------------------------------------------------------
+
+	project (os.get() .. "_analyser")
+		kind "ConsoleApp"
+		location (os.get() .. "/analyser")
+		targetname "trakmeter_analyser"
+		targetprefix ""
+
+		defines {
+			"TRAKMETER_ANALYSER=1",
+			"TRAKMETER_MULTI=1",
+			"JUCE_USE_VSTSDK_2_4=0"
+		}
+
+		-- the analyser has neither editor nor audio device, so it
+		-- only links the validation pipeline and the JUCE modules
+		-- core, events, audio_basics and audio_formats
+		excludes {
+			"../Source/audio_file_player.cpp",
+			"../Source/average_meter.cpp",
+			"../Source/benchmark.cpp",
+			"../Source/channel_slider.cpp",
+			"../Source/combined_meter.cpp",
+			"../Source/dither.cpp",
+			"../Source/editor_benchmark.cpp",
+			"../Source/frame_scheduler.cpp",
+			"../Source/meter_bar.cpp",
+			"../Source/meter_bar_average.cpp",
+			"../Source/meter_bar_peak.cpp",
+			"../Source/meter_segment_overload.cpp",
+			"../Source/meter_signal_led.cpp",
+			"../Source/meter_sprite_cache.cpp",
+			"../Source/peak_meter.cpp",
+			"../Source/plugin_editor.cpp",
+			"../Source/plugin_parameters.cpp",
+			"../Source/plugin_processor.cpp",
+			"../Source/report_writer.cpp",
+			"../Source/signal_meter.cpp",
+			"../Source/standalone_application.cpp",
+			"../Source/trakmeter.cpp",
+			"../Source/update_signaller.cpp",
+			"../Source/window_about.cpp",
+			"../Source/window_validation.cpp",
+			"../Source/parameter_juggler/**.cpp",
+			"../Source/resources/**.cpp",
+
+			"../libraries/juce/modules/juce_audio_devices/juce_audio_devices.cpp",
+			"../libraries/juce/modules/juce_audio_processors/juce_audio_processors.cpp",
+			"../libraries/juce/modules/juce_audio_utils/juce_audio_utils.cpp",
+			"../libraries/juce/modules/juce_cryptography/juce_cryptography.cpp",
+			"../libraries/juce/modules/juce_data_structures/juce_data_structures.cpp",
+			"../libraries/juce/modules/juce_graphics/juce_graphics.cpp",
+			"../libraries/juce/modules/juce_gui_basics/juce_gui_basics.cpp",
+			"../libraries/juce/modules/juce_gui_extra/juce_gui_extra.cpp",
+			"../libraries/juce/modules/juce_video/juce_video.cpp"
+		}
+
+		configuration {"linux"}
+			defines {
+				"LINUX=1"
+			}
+
+			links {
+				"dl",
+				"pthread",
+				"rt"
+			}
+
+			includedirs {
+				"/usr/include"
+			}
+
+		realtime_audit()
+
+		configuration "Debug"
+			objdir ("../bin/intermediate_" .. os.get() .. "/analyser_debug")
+
+		configuration "Release"
+			objdir ("../bin/intermediate_" .. os.get() .. "/analyser_release")
+
+--------------------------------------------------------------------------------
+
+	project (os.get() .. "_benchmark")
+		kind "ConsoleApp"
+		location (os.get() .. "/benchmark")
+		targetname "trakmeter_benchmark"
+		targetprefix ""
+
+		defines {
+			"TRAKMETER_BENCHMARK=1",
+			"TRAKMETER_MULTI=1",
+			"JUCE_USE_VSTSDK_2_4=0"
+		}
+
+		configuration {"linux"}
+			defines {
+				"LINUX=1",
+				"JUCE_USE_XSHM=1",
+				"JUCE_ALSA=1",
+				"JUCE_JACK=1",
+				"JUCE_ASIO=0",
+				"JUCE_WASAPI=0",
+				"JUCE_DIRECTSOUND=0"
+			}
+
+			links {
+				"dl",
+				"freetype",
+				"pthread",
+				"rt",
+				"X11",
+				"Xext",
+				"asound"
+			}
+
+			includedirs {
+				"/usr/include",
+				"/usr/include/freetype2"
+			}
+
+		-- allocator calls are counted in debug builds only, so that
+		-- timings of release builds do not include the audit's hooks
+		configuration "Debug"
+			defines { "TRAKMETER_REALTIME_AUDIT=1" }
+			linkoptions { "-rdynamic" }
+
+		configuration "Debug"
+			objdir ("../bin/intermediate_" .. os.get() .. "/benchmark_debug")
+
+		configuration "Release"
+			objdir ("../bin/intermediate_" .. os.get() .. "/benchmark_release")
+
 --------------------------------------------------------------------------------
 
 	project (os.get() .. "_lv2_stereo")
@@ -0,0 +1,543 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "audio_file_analyser.h"
+#include "plugin_processor.h"
+
+
+AudioFileAnalyser::AudioFileAnalyser(int crest_factor, bool transient_mode, int hop_divisor, int block_size, bool add_pause)
+/*  Constructor.
+
+    crest_factor (integer): meter's crest factor in decibel
+
+    transient_mode (Boolean): use transient mode (true) or averaging
+    mode (false)
+
+    hop_divisor (integer): number of hops per analysis window
+
+    block_size (integer): size of emulated host blocks in samples
+
+    add_pause (Boolean): append ten seconds of silence to every file
+    (like validation mode)
+
+    return value: none
+*/
+{
+    nCrestFactor = crest_factor;
+    bTransientMode = transient_mode;
+    nHopDivisor = (hop_divisor < 1) ? 1 : hop_divisor;
+    nBlockSize = (block_size < 1) ? 1 : block_size;
+    bAddPause = add_pause;
+
+    nReportChannel = -1;
+    bReportCSV = false;
+    bReportAverageMeterLevel = true;
+    bReportPeakMeterLevel = true;
+
+    nNumberOfChannels = 0;
+    nSamplesAnalysed = 0;
+    dSampleRate = 0.0;
+
+    fPeakLevels = nullptr;
+    fRmsLevels = nullptr;
+    nOverflows = nullptr;
+
+    pRingBuffer = nullptr;
+    pMeterBallistics = nullptr;
+    pMeterReporter = nullptr;
+    pCheckpoints = nullptr;
+
+    nNumberOfSamples = 0;
+
+    pDecodeQueue = nullptr;
+    pDecodeBuffers = nullptr;
+    nDecodedSamples = nullptr;
+
+    pReportQueue = nullptr;
+    nReportPositions = nullptr;
+    fReportAverageLevels = nullptr;
+    fReportPeakLevels = nullptr;
+}
+
+
+AudioFileAnalyser::~AudioFileAnalyser()
+{
+    releaseResources();
+}
+
+
+void AudioFileAnalyser::releaseResources()
+{
+    delete pRingBuffer;
+    pRingBuffer = nullptr;
+
+    delete pMeterBallistics;
+    pMeterBallistics = nullptr;
+
+    delete pMeterReporter;
+    pMeterReporter = nullptr;
+
+    delete [] fPeakLevels;
+    fPeakLevels = nullptr;
+
+    delete [] fRmsLevels;
+    fRmsLevels = nullptr;
+
+    delete [] nOverflows;
+    nOverflows = nullptr;
+
+    if (pDecodeBuffers)
+    {
+        for (int nSlot = 0; nSlot < pDecodeQueue->getNumberOfSlots(); nSlot++)
+        {
+            delete pDecodeBuffers[nSlot];
+            pDecodeBuffers[nSlot] = nullptr;
+        }
+    }
+
+    delete [] pDecodeBuffers;
+    pDecodeBuffers = nullptr;
+
+    delete [] nDecodedSamples;
+    nDecodedSamples = nullptr;
+
+    delete pDecodeQueue;
+    pDecodeQueue = nullptr;
+
+    delete [] nReportPositions;
+    nReportPositions = nullptr;
+
+    delete [] fReportAverageLevels;
+    fReportAverageLevels = nullptr;
+
+    delete [] fReportPeakLevels;
+    fReportPeakLevels = nullptr;
+
+    delete pReportQueue;
+    pReportQueue = nullptr;
+}
+
+
+void AudioFileAnalyser::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
+{
+    bReportCSV = ReportCSV;
+
+    nReportChannel = nChannel;
+    bReportAverageMeterLevel = bAverageMeterLevel;
+    bReportPeakMeterLevel = bPeakMeterLevel;
+}
+
+
+void AudioFileAnalyser::setCheckpoints(GoldenReference *checkpoints)
+/*  Store meter readings at the reference's checkpoints (or once a
+    second if it has none) during the following analyses.
+
+    checkpoints (pointer to GoldenReference): receives readings;
+    nullptr disables checkpoints
+
+    return value: none
+*/
+{
+    pCheckpoints = checkpoints;
+}
+
+
+bool AudioFileAnalyser::analyseFile(const File &audioFile, OutputStream *pReportStream, OutputStream *pMessageStream)
+/*  Run an audio file through the metering pipeline and report meter
+    readings.
+
+    audioFile (File): audio file to analyse
+
+    pReportStream (pointer to OutputStream): stream for meter readings
+
+    pMessageStream (pointer to OutputStream): stream for messages
+    (may be the same as "pReportStream")
+
+    return value (Boolean): true if the file could be analysed
+*/
+{
+    jassert(pReportStream != nullptr);
+    jassert(pMessageStream != nullptr);
+
+    nSamplesAnalysed = 0;
+
+    // uncompressed files are memory-mapped
+    AudioFormatReader *formatReader = AudioFileReader::createReaderFor(audioFile);
+
+    if (formatReader == nullptr)
+    {
+        *pMessageStream << "ERROR: could not open \"" << audioFile.getFullPathName() << "\"\n";
+        return false;
+    }
+
+    releaseResources();
+
+    nNumberOfChannels = jmin((int) formatReader->numChannels, (int) JucePlugin_MaxNumInputChannels);
+    dSampleRate = formatReader->sampleRate;
+
+    fPeakLevels = new float[nNumberOfChannels];
+    fRmsLevels = new float[nNumberOfChannels];
+    nOverflows = new int[nNumberOfChannels];
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fPeakLevels[nChannel] = 0.0f;
+        fRmsLevels[nChannel] = 0.0f;
+
+        nOverflows[nChannel] = 0;
+    }
+
+    pMeterBallistics = new MeterBallistics(nNumberOfChannels, nCrestFactor, true, false, bTransientMode);
+
+    pMeterReporter = new MeterReporter("Analyser", nNumberOfChannels, (float) dSampleRate, nCrestFactor);
+    pMeterReporter->setOutputStreams(pReportStream, pMessageStream);
+
+    // fall back to all channels if the selected one does not exist
+    int nSelectedChannel = (nReportChannel < nNumberOfChannels) ? nReportChannel : -1;
+    pMeterReporter->setReporters(nSelectedChannel, bReportCSV, bReportAverageMeterLevel, bReportPeakMeterLevel);
+
+    // set up ring buffer just like "prepareToPlay()" does
+    unsigned int uWindowSize = (unsigned int) (TRAKMETER_WINDOW_DURATION * dSampleRate / 1000.0 + 0.5);
+    unsigned int uPreDelay = uWindowSize / 2;
+    unsigned int uHopSize = uWindowSize / nHopDivisor;
+
+    unsigned int uRingBufferSize = (nBlockSize > (int) uWindowSize) ? nBlockSize : uWindowSize;
+    uRingBufferSize += uWindowSize;
+
+    pRingBuffer = new AudioRingBuffer("Analyser ring buffer", nNumberOfChannels, uRingBufferSize, uPreDelay, uHopSize);
+    pRingBuffer->setCallbackClass(this);
+    pRingBuffer->enableSlidingWindow(uWindowSize, uPreDelay);
+
+    nNumberOfSamples = formatReader->lengthInSamples;
+
+    if (bAddPause)
+    {
+        // pause for ten seconds after playback
+        nNumberOfSamples += 10 * (int64) dSampleRate;
+    }
+
+    if (pCheckpoints)
+    {
+        pCheckpoints->prepare(nNumberOfChannels, nNumberOfSamples, dSampleRate);
+    }
+
+    // pipeline: decoder thread -> analysis (this thread) -> report
+    // writer thread; the queues are bounded, so memory usage does not
+    // depend on the length of the file
+    pDecodeQueue = new PipelineQueue(nDecodeSlots);
+    pDecodeBuffers = new AudioSampleBuffer*[pDecodeQueue->getNumberOfSlots()];
+    nDecodedSamples = new int[pDecodeQueue->getNumberOfSlots()];
+
+    for (int nSlot = 0; nSlot < pDecodeQueue->getNumberOfSlots(); nSlot++)
+    {
+        pDecodeBuffers[nSlot] = new AudioSampleBuffer(nNumberOfChannels, nDecodeBlockSize);
+        nDecodedSamples[nSlot] = 0;
+    }
+
+    pReportQueue = new PipelineQueue(nReportSlots);
+    nReportPositions = new int64[pReportQueue->getNumberOfSlots()];
+    fReportAverageLevels = new float[pReportQueue->getNumberOfSlots() * nNumberOfChannels];
+    fReportPeakLevels = new float[pReportQueue->getNumberOfSlots() * nNumberOfChannels];
+
+    pMeterReporter->outputMessage("Audio file: \"" + audioFile.getFullPathName() + "\"");
+    pMeterReporter->outputMessage(String(formatReader->numChannels) + " channel(s), " + String(formatReader->sampleRate) + " Hz, " + String(formatReader->bitsPerSample) + " bit" + (AudioFileReader::isMemoryMapped(formatReader) ? " (memory-mapped)" : ""));
+    pMeterReporter->outputMessage(String::empty);
+    pMeterReporter->outputMessage("Starting analysis ...");
+    pMeterReporter->outputMessage(String::empty);
+
+    double dStartTime = Time::getMillisecondCounterHiRes();
+
+    DecoderStage decoderStage(this, formatReader);
+    ReportStage reportStage(this);
+
+    decoderStage.startThread();
+    reportStage.startThread();
+
+    runAnalysisStage();
+
+    // both stages finish on their own once the queues have been
+    // closed; the report writer must have finished before we write
+    // messages to the (possibly shared) stream
+    decoderStage.waitForThreadToExit(-1);
+    reportStage.waitForThreadToExit(-1);
+
+    double dElapsedSeconds = (Time::getMillisecondCounterHiRes() - dStartTime) / 1000.0;
+    double dAudioSeconds = nSamplesAnalysed / dSampleRate;
+
+    pMeterReporter->outputMessage("Stopping analysis ...");
+    pMeterReporter->outputMessage(String::empty);
+    pMeterReporter->outputSummary(pMeterBallistics);
+    pMeterReporter->outputMessage(String::empty);
+
+    if (dElapsedSeconds > 0.0)
+    {
+        pMeterReporter->outputMessage("Analysed " + String(dAudioSeconds, 1) + " s of audio in " + String(dElapsedSeconds, 2) + " s (" + String(dAudioSeconds / dElapsedSeconds, 1) + "x realtime)");
+
+        pMeterReporter->outputMessage(formatStatistics("decoder: ", decoderStatistics, dElapsedSeconds, "samples"));
+        pMeterReporter->outputMessage(formatStatistics("analysis:", analysisStatistics, dElapsedSeconds, "samples"));
+        pMeterReporter->outputMessage(formatStatistics("reports: ", reportStatistics, dElapsedSeconds, "readings"));
+    }
+
+    pMeterReporter->outputMessage(String::empty);
+
+    delete formatReader;
+    formatReader = nullptr;
+
+    return true;
+}
+
+
+void AudioFileAnalyser::runAnalysisStage()
+/*  Analysis stage: feed decoded samples to the ring buffer in
+    host-sized blocks and hand meter readings to the report writer.
+
+    return value: none
+*/
+{
+    bool bReporting = pMeterReporter->isReporting();
+
+    analysisStatistics.nItems = 0;
+    analysisStatistics.dWaitSeconds = 0.0;
+
+    int64 nPosition = 0;
+    int nDecodeSlot;
+
+    int nNextCheckpoint = 0;
+    int nNumberOfCheckpoints = pCheckpoints ? pCheckpoints->getNumberOfCheckpoints() : 0;
+
+    while (true)
+    {
+        double dWaitStart = Time::getMillisecondCounterHiRes();
+        bool bHasData = pDecodeQueue->startReading(nDecodeSlot);
+        analysisStatistics.dWaitSeconds += (Time::getMillisecondCounterHiRes() - dWaitStart) / 1000.0;
+
+        if (!bHasData)
+        {
+            break;
+        }
+
+        AudioSampleBuffer *pDecodeBuffer = pDecodeBuffers[nDecodeSlot];
+        int nSamplesInBuffer = nDecodedSamples[nDecodeSlot];
+
+        // feed decoded samples in host-sized blocks, so that reports
+        // are written at the same rate as during validation
+        for (int nStart = 0; nStart < nSamplesInBuffer; nStart += nBlockSize)
+        {
+            int nSamplesInBlock = jmin(nBlockSize, nSamplesInBuffer - nStart);
+
+            // report old meter readings
+            if (bReporting)
+            {
+                int nReportSlot;
+
+                dWaitStart = Time::getMillisecondCounterHiRes();
+                pReportQueue->startWriting(nReportSlot);
+                analysisStatistics.dWaitSeconds += (Time::getMillisecondCounterHiRes() - dWaitStart) / 1000.0;
+
+                int nOffset = nReportSlot * nNumberOfChannels;
+                nReportPositions[nReportSlot] = nPosition;
+
+                for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+                {
+                    fReportAverageLevels[nOffset + nChannel] = pMeterBallistics->getAverageMeterLevel(nChannel);
+                    fReportPeakLevels[nOffset + nChannel] = pMeterBallistics->getPeakMeterLevel(nChannel);
+                }
+
+                pReportQueue->finishWriting();
+            }
+
+            pRingBuffer->addSamples(*pDecodeBuffer, nStart, nSamplesInBlock);
+            nPosition += nSamplesInBlock;
+
+            // readings are taken after the first host block that
+            // reaches a checkpoint, just like a host would see them
+            while ((nNextCheckpoint < nNumberOfCheckpoints) && (nPosition >= pCheckpoints->getCheckpointPosition(nNextCheckpoint)))
+            {
+                pCheckpoints->storeReadings(nNextCheckpoint, pMeterBallistics);
+                nNextCheckpoint++;
+            }
+        }
+
+        pDecodeQueue->finishReading();
+        analysisStatistics.nItems += nSamplesInBuffer;
+    }
+
+    pReportQueue->close();
+    nSamplesAnalysed = nPosition;
+}
+
+
+String AudioFileAnalyser::formatStatistics(const String &strStage, const StageStatistics &statistics, const double dElapsedSeconds, const String &strUnit)
+/*  Format throughput of a pipeline stage.
+
+    strStage (String): name of stage
+
+    statistics (StageStatistics): items processed and time spent
+    waiting for other stages
+
+    dElapsedSeconds (double): duration of the whole analysis
+
+    strUnit (String): name of processed items
+
+    return value (String): formatted throughput
+*/
+{
+    double dBusySeconds = jmax(dElapsedSeconds - statistics.dWaitSeconds, 0.0);
+    double dBusyPercent = 100.0 * dBusySeconds / dElapsedSeconds;
+    String strThroughput = "-";
+
+    // throughput while busy is the stage's maximum speed
+    if (dBusySeconds > 0.0)
+    {
+        strThroughput = String((int64) (statistics.nItems / dBusySeconds));
+    }
+
+    return strStage + " " + strThroughput + " " + strUnit + "/s (busy " + String(dBusyPercent, 1) + " %)";
+}
+
+
+AudioFileAnalyser::DecoderStage::DecoderStage(AudioFileAnalyser *analyser, AudioFormatReader *format_reader) : Thread("Analyser decoder")
+{
+    pAnalyser = analyser;
+    pFormatReader = format_reader;
+}
+
+
+void AudioFileAnalyser::DecoderStage::run()
+/*  Decoder stage: decode the whole file (including the pause after
+    playback) into the decode queue.
+
+    return value: none
+*/
+{
+    StageStatistics &statistics = pAnalyser->decoderStatistics;
+
+    statistics.nItems = 0;
+    statistics.dWaitSeconds = 0.0;
+
+    int64 nSamplesDecoded = 0;
+
+    while ((nSamplesDecoded < pAnalyser->nNumberOfSamples) && !threadShouldExit())
+    {
+        int nSlot;
+
+        double dWaitStart = Time::getMillisecondCounterHiRes();
+        bool bHasSlot = pAnalyser->pDecodeQueue->startWriting(nSlot);
+        statistics.dWaitSeconds += (Time::getMillisecondCounterHiRes() - dWaitStart) / 1000.0;
+
+        if (!bHasSlot)
+        {
+            break;
+        }
+
+        int nSamplesToDecode = (int) jmin((int64) nDecodeBlockSize, pAnalyser->nNumberOfSamples - nSamplesDecoded);
+
+        // samples after the end of the file are cleared, which takes
+        // care of the pause after playback
+        AudioFileReader::readSamples(pFormatReader, pAnalyser->pDecodeBuffers[nSlot], nSamplesToDecode, nSamplesDecoded);
+        pAnalyser->nDecodedSamples[nSlot] = nSamplesToDecode;
+
+        pAnalyser->pDecodeQueue->finishWriting();
+
+        nSamplesDecoded += nSamplesToDecode;
+        statistics.nItems = nSamplesDecoded;
+    }
+
+    pAnalyser->pDecodeQueue->close();
+}
+
+
+AudioFileAnalyser::ReportStage::ReportStage(AudioFileAnalyser *analyser) : Thread("Analyser reports")
+{
+    pAnalyser = analyser;
+}
+
+
+void AudioFileAnalyser::ReportStage::run()
+/*  Report stage: format meter readings and write them to the report
+    stream.
+
+    return value: none
+*/
+{
+    StageStatistics &statistics = pAnalyser->reportStatistics;
+
+    statistics.nItems = 0;
+    statistics.dWaitSeconds = 0.0;
+
+    while (!threadShouldExit())
+    {
+        int nSlot;
+
+        double dWaitStart = Time::getMillisecondCounterHiRes();
+        bool bHasData = pAnalyser->pReportQueue->startReading(nSlot);
+        statistics.dWaitSeconds += (Time::getMillisecondCounterHiRes() - dWaitStart) / 1000.0;
+
+        if (!bHasData)
+        {
+            break;
+        }
+
+        int nOffset = nSlot * pAnalyser->nNumberOfChannels;
+
+        pAnalyser->pMeterReporter->setPosition(pAnalyser->nReportPositions[nSlot]);
+        pAnalyser->pMeterReporter->outputReport(pAnalyser->fReportAverageLevels + nOffset, pAnalyser->fReportPeakLevels + nOffset);
+
+        pAnalyser->pReportQueue->finishReading();
+        statistics.nItems++;
+    }
+}
+
+
+int64 AudioFileAnalyser::getSamplesAnalysed()
+/*  Get number of samples (per channel) processed by the last call of
+    "analyseFile()", including the pause after playback.
+
+    return value (64-bit integer): number of samples
+*/
+{
+    return nSamplesAnalysed;
+}
+
+
+void AudioFileAnalyser::processBufferChunk(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
+{
+    unsigned int uWindowSize = pRingBuffer->getSlidingWindowSize();
+    float fProcessedSeconds = (float) uChunkSize / (float) dSampleRate;
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        double dSumOfSquares;
+        pRingBuffer->getSlidingWindow(nChannel, fPeakLevels[nChannel], dSumOfSquares, nOverflows[nChannel]);
+        fRmsLevels[nChannel] = (float) sqrt(dSumOfSquares / uWindowSize);
+    }
+
+    pMeterBallistics->updateAllChannels(fProcessedSeconds, fPeakLevels, fRmsLevels, nOverflows);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,153 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __AUDIO_FILE_ANALYSER_H__
+#define __AUDIO_FILE_ANALYSER_H__
+
+class AudioFileAnalyser;
+
+#include "JuceHeader.h"
+#include "audio_file_reader.h"
+#include "audio_ring_buffer.h"
+#include "golden_reference.h"
+#include "meter_ballistics.h"
+#include "meter_reporter.h"
+#include "pipeline_queue.h"
+
+
+//==============================================================================
+/**
+   Runs audio files through the metering pipeline (ring buffer and
+   meter ballistics) as fast as possible and writes the same reports
+   as validation mode.  Host blocks are emulated, so the readings
+   match those of the plug-in.
+
+   Decoding, analysis and report formatting run on separate threads
+   connected by bounded queues.
+*/
+class AudioFileAnalyser : public AudioRingBufferCallback
+{
+public:
+    AudioFileAnalyser(int crest_factor, bool transient_mode, int hop_divisor, int block_size, bool add_pause);
+    ~AudioFileAnalyser();
+
+    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    void setCheckpoints(GoldenReference *checkpoints);
+    bool analyseFile(const File &audioFile, OutputStream *pReportStream, OutputStream *pMessageStream);
+    int64 getSamplesAnalysed();
+
+    void processBufferChunk(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
+
+private:
+    JUCE_LEAK_DETECTOR(AudioFileAnalyser);
+
+    class DecoderStage : public Thread
+    {
+    public:
+        DecoderStage(AudioFileAnalyser *analyser, AudioFormatReader *format_reader);
+        void run();
+
+    private:
+        JUCE_LEAK_DETECTOR(DecoderStage);
+
+        AudioFileAnalyser *pAnalyser;
+        AudioFormatReader *pFormatReader;
+    };
+
+    class ReportStage : public Thread
+    {
+    public:
+        ReportStage(AudioFileAnalyser *analyser);
+        void run();
+
+    private:
+        JUCE_LEAK_DETECTOR(ReportStage);
+
+        AudioFileAnalyser *pAnalyser;
+    };
+
+    struct StageStatistics
+    {
+        int64 nItems;
+        double dWaitSeconds;
+    };
+
+    // number of samples decoded at a time
+    static const int nDecodeBlockSize = 16384;
+
+    // number of decoded blocks and meter readings that may be queued
+    static const int nDecodeSlots = 8;
+    static const int nReportSlots = 1024;
+
+    int nCrestFactor;
+    bool bTransientMode;
+    int nHopDivisor;
+    int nBlockSize;
+    bool bAddPause;
+
+    int nReportChannel;
+    bool bReportCSV;
+    bool bReportAverageMeterLevel;
+    bool bReportPeakMeterLevel;
+
+    int nNumberOfChannels;
+    int64 nNumberOfSamples;
+    int64 nSamplesAnalysed;
+    double dSampleRate;
+
+    float *fPeakLevels;
+    float *fRmsLevels;
+    int *nOverflows;
+
+    AudioRingBuffer *pRingBuffer;
+    MeterBallistics *pMeterBallistics;
+    MeterReporter *pMeterReporter;
+    GoldenReference *pCheckpoints;
+
+    PipelineQueue *pDecodeQueue;
+    AudioSampleBuffer **pDecodeBuffers;
+    int *nDecodedSamples;
+
+    PipelineQueue *pReportQueue;
+    int64 *nReportPositions;
+    float *fReportAverageLevels;
+    float *fReportPeakLevels;
+
+    StageStatistics decoderStatistics;
+    StageStatistics analysisStatistics;
+    StageStatistics reportStatistics;
+
+    void releaseResources();
+    void runAnalysisStage();
+
+    String formatStatistics(const String &strStage, const StageStatistics &statistics, const double dElapsedSeconds, const String &strUnit);
+};
+
+#endif   // __AUDIO_FILE_ANALYSER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -26,50 +26,36 @@
 #include "audio_file_player.h"
 
 
-AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics *meter_ballistics, int crest_factor)
+AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics *meter_ballistics, int crest_factor) : Thread("Validation decoder")
 {
-    nReportChannel = -1;
-    bReports = false;
-    bReportCSV = false;
-    bReportAverageMeterLevel = false;
-    bReportPeakMeterLevel = false;
-
-    bHeaderIsWritten = false;
-    setCrestFactor(crest_factor);
-
     pMeterBallistics = meter_ballistics;
-
-    // try "300" for uncorrelated band-limited pink noise
-    nSamplesMovingAverage = 50;
     nNumberOfChannels = pMeterBallistics->getNumberOfChannels();
 
-    pAverager_AverageMeterLevels = new Averager*[nNumberOfChannels];
-    pAverager_PeakMeterLevels = new Averager*[nNumberOfChannels];
+    pMeterReporter = new MeterReporter("Validation", nNumberOfChannels, (float) sample_rate, crest_factor);
+    pReportWriter = new ReportWriter("Validation", nNumberOfChannels, (float) sample_rate, crest_factor);
 
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-    {
-        pAverager_AverageMeterLevels[nChannel] = new Averager(nSamplesMovingAverage, fMeterMinimumDecibel);
-        pAverager_PeakMeterLevels[nChannel] = new Averager(nSamplesMovingAverage, fMeterMinimumDecibel);
-    }
+    // uncompressed files are memory-mapped
+    formatReader = AudioFileReader::createReaderFor(audioFile);
+
+    nSamplesDecoded = 0;
+    nSamplesPlayed = 0;
 
-    AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
+    pPrefetchFifo = nullptr;
+    pPrefetchBuffer = nullptr;
+    pDecodeBuffer = nullptr;
 
-    AudioFormatReader *formatReader = formatManager.createReaderFor(audioFile);
+    bPlaybackFinished = false;
 
     if (formatReader)
     {
-        audioFileSource = new AudioFormatReaderSource(formatReader, true);
-        bIsPlaying = true;
+        nIsPlaying = 1;
 
-        nNumberOfSamples = audioFileSource->getTotalLength();
+        nNumberOfSamples = formatReader->lengthInSamples;
         // pause for ten seconds after playback
         nNumberOfSamples += 10 * sample_rate;
 
         outputMessage("Audio file: \"" + audioFile.getFullPathName() + "\"");
-        outputMessage(String(formatReader->numChannels) + " channel(s), " + String(formatReader->sampleRate) + " Hz, " + String(formatReader->bitsPerSample) + " bit");
-
-        fSampleRate = (float) formatReader->sampleRate;
+        outputMessage(String(formatReader->numChannels) + " channel(s), " + String(formatReader->sampleRate) + " Hz, " + String(formatReader->bitsPerSample) + " bit" + (AudioFileReader::isMemoryMapped(formatReader) ? " (memory-mapped)" : ""));
 
         if (formatReader->sampleRate != sample_rate)
         {
@@ -81,328 +67,280 @@ AudioFilePlayer::AudioFilePlayer(const File audioFile, int sample_rate, MeterBal
         outputMessage(String::empty);
         outputMessage("Starting validation ...");
         outputMessage(String::empty);
+
+        int nPrefetchSize = nPrefetchSeconds * sample_rate;
+
+        pPrefetchFifo = new AbstractFifo(nPrefetchSize);
+        pPrefetchBuffer = new AudioSampleBuffer(nNumberOfChannels, nPrefetchSize);
+        pDecodeBuffer = new AudioSampleBuffer(nNumberOfChannels, nDecodeBlockSize);
+
+        // fill FIFO before playback starts, then keep it filled on a
+        // background thread
+        while (decodeBlock())
+        {
+            // nothing to do
+        }
+
+        startThread();
     }
     else
     {
-        audioFileSource = nullptr;
-        bIsPlaying = false;
-        bReports = false;
+        nIsPlaying = 0;
+        pMeterReporter->disableReports();
+        pReportWriter->disableReports();
     }
 }
 
 
 AudioFilePlayer::~AudioFilePlayer()
 {
-    if (isPlaying())
+    // stop decoder before deleting its reader
+    stopThread(2000);
+
+    // validation has been stopped early, or the decoder thread has
+    // been stopped before it could notice the end of playback
+    if (formatReader && !bPlaybackFinished)
     {
-        outputMessage("Stopping validation ...");
+        finishPlayback();
     }
 
-    delete audioFileSource;
-    audioFileSource = nullptr;
+    delete formatReader;
+    formatReader = nullptr;
 
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-    {
-        delete pAverager_AverageMeterLevels[nChannel];
-        pAverager_AverageMeterLevels[nChannel] = nullptr;
+    delete pPrefetchFifo;
+    pPrefetchFifo = nullptr;
 
-        delete pAverager_PeakMeterLevels[nChannel];
-        pAverager_PeakMeterLevels[nChannel] = nullptr;
-    }
+    delete pPrefetchBuffer;
+    pPrefetchBuffer = nullptr;
 
-    delete [] pAverager_AverageMeterLevels;
-    pAverager_AverageMeterLevels = nullptr;
+    delete pDecodeBuffer;
+    pDecodeBuffer = nullptr;
 
-    delete [] pAverager_PeakMeterLevels;
-    pAverager_PeakMeterLevels = nullptr;
+    // write remaining reports
+    delete pReportWriter;
+    pReportWriter = nullptr;
+
+    delete pMeterReporter;
+    pMeterReporter = nullptr;
 }
 
 
 void AudioFilePlayer::setCrestFactor(int crest_factor)
 {
-    fCrestFactor = float(crest_factor);
-    fMeterMinimumDecibel = MeterBallistics::getMeterMinimumDecibel() + fCrestFactor;
+    pMeterReporter->setCrestFactor(crest_factor);
+    pReportWriter->setCrestFactor(crest_factor);
 }
 
 
-void AudioFilePlayer::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
-{
-    bReportCSV = ReportCSV;
+void AudioFilePlayer::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, const File &fileReport, bool bReportBinary)
+/*  Select reports and start the report writer.  Must be called once,
+    before the player is handed to the audio thread.
 
-    nReportChannel = nChannel;
-    bReportAverageMeterLevel = bAverageMeterLevel;
-    bReportPeakMeterLevel = bPeakMeterLevel;
+    fileReport (File): report file; write to the debug log if this is
+    File::nonexistent
 
-    bReports = bReportAverageMeterLevel || bReportPeakMeterLevel;
-}
+    bReportBinary (Boolean): write binary records instead of text
 
-
-bool AudioFilePlayer::isPlaying()
+    return value: none
+*/
 {
-    if (bIsPlaying)
-    {
-        if (audioFileSource->getNextReadPosition() < nNumberOfSamples)
-        {
-            return true;
-        }
-        else
-        {
-            outputMessage("Stopping validation ...");
-
-            bIsPlaying = false;
-            bReports = false;
-            return false;
-        }
-    }
-    else
+    if (!isPlaying())
     {
-        return false;
+        return;
     }
-}
 
+    pReportWriter->setReporters(nChannel, ReportCSV, bAverageMeterLevel, bPeakMeterLevel);
 
-void AudioFilePlayer::fillBufferChunk(AudioSampleBuffer *buffer)
-{
-    // report old meter readings
-    if (bReports)
+    if (fileReport != File::nonexistent)
     {
-        if (bReportCSV)
+        if (pReportWriter->setOutputFile(fileReport, bReportBinary))
         {
-            outputReportCSVLine();
+            outputMessage("Report file: \"" + fileReport.getFullPathName() + "\"");
         }
         else
         {
-            outputReportPlain();
+            outputMessage("WARNING: could not create report file \"" + fileReport.getFullPathName() + "\"!");
         }
+
+        outputMessage(String::empty);
     }
 
-    if (isPlaying())
-    {
-        AudioSourceChannelInfo channelInfo;
-        channelInfo.buffer = buffer;
-        channelInfo.startSample = 0;
-        channelInfo.numSamples = buffer->getNumSamples();
+    pReportWriter->startThread();
+}
 
-        channelInfo.clearActiveBufferRegion();
-        audioFileSource->getNextAudioBlock(channelInfo);
-    }
+
+bool AudioFilePlayer::isPlaying()
+/*  Check whether the file is still being played.  Safe to call from
+    any thread.
+
+    return value (Boolean): false once the audio thread has played
+    the whole file (including the pause after playback)
+*/
+{
+    return nIsPlaying.get() != 0;
 }
 
 
-void AudioFilePlayer::outputReportPlain(void)
+void AudioFilePlayer::fillBufferChunk(AudioSampleBuffer *buffer)
 {
-    if (bReportAverageMeterLevel)
+    if (!isPlaying())
     {
-        if (nReportChannel < 0)
-        {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                float fAverageMeterLevel = pMeterBallistics->getAverageMeterLevel(nChannel);
-                String strPrefix = "average level (ch. " + String(nChannel + 1) + "):  ";
-                String strSuffix = " dB";
-                outputValue(fAverageMeterLevel, pAverager_AverageMeterLevels[nChannel], fCrestFactor, strPrefix, strSuffix);
-            }
-        }
-        else
-        {
-            float fAverageMeterLevel = pMeterBallistics->getAverageMeterLevel(nReportChannel);
-            String strPrefix = "average level (ch. " + String(nReportChannel + 1) + "):  ";
-            String strSuffix = " dB";
-            outputValue(fAverageMeterLevel, pAverager_AverageMeterLevels[nReportChannel], fCrestFactor, strPrefix, strSuffix);
-        }
+        return;
     }
 
-    if (bReportPeakMeterLevel)
+    // queue old meter readings; formatting and writing is done on
+    // the report writer's thread
+    pReportWriter->pushReadings(nSamplesPlayed, pMeterBallistics);
+
+    // end of file: logging allocates memory, so only clear the flag
+    // and leave the summary to the decoder thread
+    if (nSamplesPlayed >= nNumberOfSamples)
     {
-        if (nReportChannel < 0)
-        {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                float fPeakMeterLevel = pMeterBallistics->getPeakMeterLevel(nChannel);
-                String strPrefix = "peak level (ch. " + String(nChannel + 1) + "):     ";
-                String strSuffix = " dB";
-                outputValue(fPeakMeterLevel, pAverager_PeakMeterLevels[nChannel], fCrestFactor, strPrefix, strSuffix);
-            }
-        }
-        else
-        {
-            float fPeakMeterLevel = pMeterBallistics->getPeakMeterLevel(nReportChannel);
-            String strPrefix = "peak level (ch. " + String(nReportChannel + 1) + "):     ";
-            String strSuffix = " dB";
-            outputValue(fPeakMeterLevel, pAverager_PeakMeterLevels[nReportChannel], fCrestFactor, strPrefix, strSuffix);
-        }
+        nIsPlaying = 0;
+        return;
     }
 
-    outputMessage(String::empty);
-}
+    buffer->clear();
 
+    // only copy decoded samples, never decode here
+    int nSamplesToRead = (int) jmin((int64) buffer->getNumSamples(), nNumberOfSamples - nSamplesPlayed);
+    int nChannels = jmin(buffer->getNumChannels(), nNumberOfChannels);
 
-void AudioFilePlayer::outputReportCSVHeader(void)
-{
-    bHeaderIsWritten = true;
-    String strOutput = "\"timecode\"\t";
+    int nStart1, nSize1, nStart2, nSize2;
+    pPrefetchFifo->prepareToRead(nSamplesToRead, nStart1, nSize1, nStart2, nSize2);
 
-    if (bReportAverageMeterLevel)
+    for (int nChannel = 0; nChannel < nChannels; nChannel++)
     {
-        if (nReportChannel < 0)
+        if (nSize1 > 0)
         {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                strOutput += "\"avg_" + String(nChannel + 1) + "\"\t";
-            }
+            buffer->copyFrom(nChannel, 0, *pPrefetchBuffer, nChannel, nStart1, nSize1);
         }
-        else
+
+        if (nSize2 > 0)
         {
-            strOutput += "\"avg_" + String(nReportChannel + 1) + "\"\t";
+            buffer->copyFrom(nChannel, nSize1, *pPrefetchBuffer, nChannel, nStart2, nSize2);
         }
     }
 
-    if (bReportPeakMeterLevel)
+    pPrefetchFifo->finishedRead(nSize1 + nSize2);
+    nSamplesPlayed += nSize1 + nSize2;
+
+    // decoder has fallen behind: output silence for the missing
+    // samples and continue where we left off next time
+    if ((nSize1 + nSize2) < nSamplesToRead)
     {
-        if (nReportChannel < 0)
-        {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                strOutput += "\"pk_" + String(nChannel + 1) + "\"\t";
-            }
-        }
-        else
-        {
-            strOutput += "\"pk_" + String(nReportChannel + 1) + "\"\t";
-        }
+        ++nUnderruns;
     }
-
-    Logger::outputDebugString(strOutput);
 }
 
 
-void AudioFilePlayer::outputReportCSVLine(void)
+int AudioFilePlayer::getNumberOfUnderruns()
+/*  Get number of audio blocks that could not be filled completely
+    because the decoder thread had fallen behind.
+
+    return value (integer): number of underruns
+*/
 {
-    String strOutput;
+    return nUnderruns.get();
+}
 
-    if (!bHeaderIsWritten)
-    {
-        outputReportCSVHeader();
-    }
 
-    if (bReportAverageMeterLevel)
-    {
-        if (nReportChannel < 0)
-        {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                float fAverageMeterLevel = pMeterBallistics->getAverageMeterLevel(nChannel);
-                strOutput += formatValue(fAverageMeterLevel);
-            }
-        }
-        else
-        {
-            float fAverageMeterLevel = pMeterBallistics->getAverageMeterLevel(nReportChannel);
-            strOutput += formatValue(fAverageMeterLevel);
-        }
-    }
+void AudioFilePlayer::run()
+/*  Decoder thread: keep the prefetch FIFO filled until the whole file
+    (including the pause after playback) has been decoded, then wait
+    for the audio thread to play it and write the summary.
 
-    if (bReportPeakMeterLevel)
+    return value: none
+*/
+{
+    while (!threadShouldExit())
     {
-        if (nReportChannel < 0)
+        if (!isPlaying())
         {
-            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
-            {
-                float fPeakMeterLevel = pMeterBallistics->getPeakMeterLevel(nChannel);
-                strOutput += formatValue(fPeakMeterLevel);
-            }
+            finishPlayback();
+            break;
         }
-        else
+
+        // FIFO is full or the file has been decoded completely, so
+        // wait for the audio thread to catch up
+        if (!decodeBlock())
         {
-            float fPeakMeterLevel = pMeterBallistics->getPeakMeterLevel(nReportChannel);
-            strOutput += formatValue(fPeakMeterLevel);
+            wait(10);
         }
     }
-
-    Logger::outputDebugString("\"" + formatTime() + "\"\t" + strOutput);
 }
 
 
-String AudioFilePlayer::formatTime(void)
-{
-    float fTime = audioFileSource->getNextReadPosition() / fSampleRate;
-
-    // check for NaN
-    if (fTime != fTime)
-    {
-        fTime = 0.0f;
-    }
-
-    int nTime = int(fTime);
-    int nMilliSeconds = int(1000.0f * (fTime - nTime) + 0.5f);
+void AudioFilePlayer::finishPlayback()
+/*  Write summary of the validation and stop reporting.  Must not be
+    called on the audio thread.
 
-    String strMinutes = String(nTime / 60).paddedLeft('0', 2);
-    String strSeconds = String(nTime % 60).paddedLeft('0', 2);
-    String strMilliSeconds = String(nMilliSeconds).paddedLeft('0', 3);
-
-    return strMinutes + ":" + strSeconds + "." + strMilliSeconds;
-}
-
-
-String AudioFilePlayer::formatValue(const float fValue)
+    return value: none
+*/
 {
-    String strValue;
-
-    if (fValue < 0.0f)
+    if (getNumberOfUnderruns() > 0)
     {
-        strValue = String(fValue, 2);
+        outputMessage("WARNING: " + String(getNumberOfUnderruns()) + " buffer underrun(s) during validation!");
     }
-    else
+
+    if (pReportWriter->getNumberOfDroppedRecords() > 0)
     {
-        strValue = "+" + String(fValue, 2);
+        outputMessage("WARNING: " + String(pReportWriter->getNumberOfDroppedRecords()) + " report(s) dropped during validation!");
     }
 
-    return (strValue + "\t");
+    outputMessage("Stopping validation ...");
+
+    bPlaybackFinished = true;
+    pMeterReporter->disableReports();
+    pReportWriter->disableReports();
 }
 
 
-void AudioFilePlayer::outputValue(const float fValue, Averager *pAverager, const float fCorrectionFactor, const String &strPrefix, const String &strSuffix)
+bool AudioFilePlayer::decodeBlock()
+/*  Decode a block of samples into the prefetch FIFO.  Must not be
+    called on the audio thread.
+
+    return value (Boolean): true if a block was decoded, false if the
+    FIFO is full or the file has been decoded completely
+*/
 {
-    String strValue;
+    int nSamplesToDecode = (int) jmin((int64) nDecodeBlockSize, nNumberOfSamples - nSamplesDecoded);
 
-    if (fValue < 0.0f)
+    if ((nSamplesToDecode <= 0) || (pPrefetchFifo->getFreeSpace() < nSamplesToDecode))
     {
-        strValue = String(fValue, 2) + strSuffix;
-    }
-    else
-    {
-        strValue = "+" + String(fValue, 2) + strSuffix;
+        return false;
     }
 
-    String strSimpleMovingAverage;
+    // samples after the end of the file are cleared, which takes
+    // care of the pause after playback
+    AudioFileReader::readSamples(formatReader, pDecodeBuffer, nSamplesToDecode, nSamplesDecoded);
 
-    if (pAverager)
+    int nStart1, nSize1, nStart2, nSize2;
+    pPrefetchFifo->prepareToWrite(nSamplesToDecode, nStart1, nSize1, nStart2, nSize2);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
     {
-        pAverager->addSample(fValue - fCorrectionFactor);
+        if (nSize1 > 0)
+        {
+            pPrefetchBuffer->copyFrom(nChannel, nStart1, *pDecodeBuffer, nChannel, 0, nSize1);
+        }
 
-        if (pAverager->isValid())
+        if (nSize2 > 0)
         {
-            float fSimpleMovingAverage = pAverager->getSimpleMovingAverage() + fCorrectionFactor;
-
-            if (fSimpleMovingAverage < 0.0f)
-            {
-                strSimpleMovingAverage = "   SMA(" + String(nSamplesMovingAverage) + "): " + String(fSimpleMovingAverage, 2) + strSuffix;
-            }
-            else
-            {
-                strSimpleMovingAverage = "   SMA(" + String(nSamplesMovingAverage) + "): +" + String(fSimpleMovingAverage, 2) + strSuffix;
-            }
+            pPrefetchBuffer->copyFrom(nChannel, nStart2, *pDecodeBuffer, nChannel, nSize1, nSize2);
         }
     }
 
-    outputMessage(strPrefix + strValue + strSimpleMovingAverage);
+    pPrefetchFifo->finishedWrite(nSize1 + nSize2);
+    nSamplesDecoded += nSize1 + nSize2;
+
+    return true;
 }
 
 
 void AudioFilePlayer::outputMessage(const String &strMessage)
 {
-
-    Logger::outputDebugString("[Validation - " + formatTime() + "] " + strMessage);
+    pMeterReporter->outputMessage(strMessage);
 }
 
 
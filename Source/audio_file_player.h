@@ -29,11 +29,23 @@
 class AudioFilePlayer;
 
 #include "JuceHeader.h"
-#include "averager.h"
+#include "audio_file_reader.h"
 #include "meter_ballistics.h"
-
-
-class AudioFilePlayer
+#include "meter_reporter.h"
+#include "report_writer.h"
+
+
+//==============================================================================
+/**
+   Plays an audio file for validation.  The file is decoded on a
+   background thread into a lock-free FIFO, so the audio thread only
+   has to copy samples.  When the FIFO runs dry, the audio thread
+   outputs silence and counts an underrun instead of waiting.  Meter
+   readings are handed to a report writer, which formats and writes
+   them on its own thread.  At the end of the file, the audio thread
+   only clears a flag; the summary is written by the decoder thread.
+*/
+class AudioFilePlayer : public Thread
 {
 public:
     AudioFilePlayer(const File audioFile, int sample_rate, MeterBallistics *meter_ballistics, int crest_factor);
@@ -42,40 +54,43 @@ public:
     bool isPlaying();
     void fillBufferChunk(AudioSampleBuffer *buffer);
     void setCrestFactor(int crest_factor);
-    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, const File &fileReport, bool bReportBinary);
+
+    int getNumberOfUnderruns();
+
+    void run();
 
 private:
     JUCE_LEAK_DETECTOR(AudioFilePlayer);
 
-    bool bIsPlaying;
-    bool bHeaderIsWritten;
-    int nSamplesMovingAverage;
-    int64 nNumberOfSamples;
-    float fSampleRate;
-    float fCrestFactor;
-    float fMeterMinimumDecibel;
+    // size of prefetch FIFO in seconds
+    static const int nPrefetchSeconds = 3;
 
-    int nNumberOfChannels;
-    int nReportChannel;
-    bool bReports;
-    bool bReportCSV;
-    bool bReportAverageMeterLevel;
-    bool bReportPeakMeterLevel;
+    // number of samples decoded at a time
+    static const int nDecodeBlockSize = 4096;
 
-    Averager **pAverager_AverageMeterLevels;
-    Averager **pAverager_PeakMeterLevels;
+    bool decodeBlock();
+    void finishPlayback();
 
-    AudioFormatReaderSource *audioFileSource;
-    MeterBallistics *pMeterBallistics;
+    // cleared by the audio thread at the end of the file
+    Atomic<int> nIsPlaying;
+    bool bPlaybackFinished;
 
-    void outputReportPlain(void);
-    void outputReportCSVHeader(void);
-    void outputReportCSVLine(void);
+    int64 nNumberOfSamples;
+    int64 nSamplesDecoded;
+    int64 nSamplesPlayed;
+    Atomic<int> nUnderruns;
+    int nNumberOfChannels;
 
-    String formatTime(void);
-    String formatValue(const float fValue);
+    AudioFormatReader *formatReader;
+
+    AbstractFifo *pPrefetchFifo;
+    AudioSampleBuffer *pPrefetchBuffer;
+    AudioSampleBuffer *pDecodeBuffer;
+    MeterBallistics *pMeterBallistics;
+    MeterReporter *pMeterReporter;
+    ReportWriter *pReportWriter;
 
-    void outputValue(const float fValue, Averager *pAverager, const float fCorrectionFactor, const String &strPrefix, const String &strSuffix);
     void outputMessage(const String &strMessage);
 };
 
@@ -0,0 +1,178 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "audio_file_reader.h"
+
+#if JUCE_LINUX || JUCE_MAC
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+// JUCE keeps the mapped memory of its readers protected; forming a
+// member pointer through a derived class is the legal way to reach it
+class MappedMemoryAccess : public MemoryMappedAudioFormatReader
+{
+public:
+    static const void *getSamplePointer(const MemoryMappedAudioFormatReader *reader, int64 nSample)
+    {
+        return (reader->*(&MappedMemoryAccess::sampleToPointer))(nSample);
+    }
+};
+
+
+AudioFormatReader *AudioFileReader::createReaderFor(const File &audioFile)
+/*  Create reader for an audio file, preferring memory-mapped access.
+
+    audioFile (File): audio file to open
+
+    return value (pointer to AudioFormatReader): reader (owned by the
+    caller) or nullptr if the file could not be opened
+*/
+{
+    WavAudioFormat wavFormat;
+    AiffAudioFormat aiffFormat;
+
+    MemoryMappedAudioFormatReader *mappedReader = nullptr;
+
+    if (wavFormat.canHandleFile(audioFile))
+    {
+        mappedReader = createMappedReader(wavFormat, audioFile);
+    }
+    else if (aiffFormat.canHandleFile(audioFile))
+    {
+        mappedReader = createMappedReader(aiffFormat, audioFile);
+    }
+
+    if (mappedReader)
+    {
+        return mappedReader;
+    }
+
+    // compressed formats (and files that cannot be mapped)
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    return formatManager.createReaderFor(audioFile);
+}
+
+
+MemoryMappedAudioFormatReader *AudioFileReader::createMappedReader(AudioFormat &format, const File &audioFile)
+{
+    MemoryMappedAudioFormatReader *mappedReader = format.createMemoryMappedReader(audioFile);
+
+    if (mappedReader == nullptr)
+    {
+        return nullptr;
+    }
+
+    // fails for compressed data and if the address space is exhausted
+    if ((mappedReader->lengthInSamples <= 0) || !mappedReader->mapEntireFile())
+    {
+        delete mappedReader;
+        mappedReader = nullptr;
+
+        return nullptr;
+    }
+
+    adviseSequentialAccess(mappedReader);
+    return mappedReader;
+}
+
+
+void AudioFileReader::adviseSequentialAccess(MemoryMappedAudioFormatReader *reader)
+/*  Tell the kernel that the mapped samples will be read once from
+    start to end, so that it reads ahead aggressively and drops pages
+    that have been processed.
+
+    reader (pointer to MemoryMappedAudioFormatReader): mapped reader
+
+    return value: none
+*/
+{
+#if JUCE_LINUX || JUCE_MAC
+    const char *pStart = (const char *) MappedMemoryAccess::getSamplePointer(reader, 0);
+    const char *pEnd = (const char *) MappedMemoryAccess::getSamplePointer(reader, reader->lengthInSamples);
+
+    // "madvise" needs a page-aligned address
+    uintptr_t uPageSize = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t uStart = ((uintptr_t) pStart) & ~(uPageSize - 1);
+    size_t uLength = (size_t) (((uintptr_t) pEnd) - uStart);
+
+    // only a hint, so errors can be ignored
+    madvise((void *) uStart, uLength, MADV_SEQUENTIAL);
+    madvise((void *) uStart, uLength, MADV_WILLNEED);
+#else
+    (void) reader;
+#endif
+}
+
+
+bool AudioFileReader::isMemoryMapped(AudioFormatReader *reader)
+/*  Check whether a reader accesses its file through memory mapping.
+
+    reader (pointer to AudioFormatReader): reader to check
+
+    return value (Boolean): true if file is memory-mapped
+*/
+{
+    return dynamic_cast<MemoryMappedAudioFormatReader *>(reader) != nullptr;
+}
+
+
+void AudioFileReader::readSamples(AudioFormatReader *reader, AudioSampleBuffer *buffer, int nNumSamples, int64 nStartSample)
+/*  Read samples into the beginning of a buffer.  Samples that lie
+    beyond the end of the file are cleared (memory-mapped readers
+    refuse to read them).
+
+    reader (pointer to AudioFormatReader): reader
+
+    buffer (pointer to AudioSampleBuffer): destination
+
+    nNumSamples (integer): number of samples to read
+
+    nStartSample (64-bit integer): position of first sample in file
+
+    return value: none
+*/
+{
+    int nSamplesInFile = (int) jlimit((int64) 0, (int64) nNumSamples, reader->lengthInSamples - nStartSample);
+
+    if (nSamplesInFile > 0)
+    {
+        // converts directly from the mapped file into the buffer
+        reader->read(buffer, 0, nSamplesInFile, nStartSample, true, true);
+    }
+
+    if (nSamplesInFile < nNumSamples)
+    {
+        buffer->clear(nSamplesInFile, nNumSamples - nSamplesInFile);
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -23,43 +23,38 @@
 
 ---------------------------------------------------------------------------- */
 
-#ifndef __METER_SEGMENT_H__
-#define __METER_SEGMENT_H__
+#ifndef __AUDIO_FILE_READER_H__
+#define __AUDIO_FILE_READER_H__
+
+class AudioFileReader;
 
 #include "JuceHeader.h"
 
 
 //==============================================================================
 /**
+   Opens audio files for validation and offline analysis.  Uncompressed
+   WAV and AIFF files are memory-mapped, so samples are converted
+   straight from the page cache into the caller's buffers without read
+   system calls; all other files are opened through
+   AudioFormatManager.
+
+   Unlike JUCE's memory-mapped readers, the readers returned here may
+   be read past the end of the file (missing samples are cleared).
 */
-class MeterSegment : public Component
+class AudioFileReader
 {
 public:
-    MeterSegment(const String &componentName, float fThreshold, float fRange, bool bDiscreteLevels, bool bDisplayPeaks, int nColor);
-    ~MeterSegment();
-
-    void setLevels(float fLevel, float fLevelPeak);
-    void paint(Graphics &g);
-    void resized();
-    void visibilityChanged();
+    static AudioFormatReader *createReaderFor(const File &audioFile);
+    static bool isMemoryMapped(AudioFormatReader *reader);
+    static void readSamples(AudioFormatReader *reader, AudioSampleBuffer *buffer, int nNumSamples, int64 nStartSample);
 
 private:
-    JUCE_LEAK_DETECTOR(MeterSegment);
-
-    float fHue;
-    float fBrightness;
-
-    float fLowerThreshold;
-    float fUpperThreshold;
-    float fThresholdRange;
-
-    bool bPeakMarker;
-    bool discreteLevels;
-    bool displayPeaks;
+    static MemoryMappedAudioFormatReader *createMappedReader(AudioFormat &format, const File &audioFile);
+    static void adviseSequentialAccess(MemoryMappedAudioFormatReader *reader);
 };
 
-
-#endif  // __METER_SEGMENT_H__
+#endif   // __AUDIO_FILE_READER_H__
 
 
 // Local Variables:
@@ -25,6 +25,204 @@
 
 #include "audio_ring_buffer.h"
 
+
+// The analysis kernels below determine peak level, sum of squares and
+// number of overflows of a contiguous span of samples in a single
+// pass.  On x86 processors, SSE2 and AVX2 versions are used whenever
+// the CPU supports them (the AVX2 kernel is selected at run-time, so
+// the binaries still run on older processors).
+
+#if (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+#define RING_BUFFER_SSE2_KERNEL 1
+#define RING_BUFFER_AVX2_KERNEL 1
+#define RING_BUFFER_TARGET_SSE2 __attribute__((target("sse2")))
+#define RING_BUFFER_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined (_MSC_VER) && (defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define RING_BUFFER_SSE2_KERNEL 1
+#define RING_BUFFER_AVX2_KERNEL 0
+#define RING_BUFFER_TARGET_SSE2
+#include <emmintrin.h>
+#else
+#define RING_BUFFER_SSE2_KERNEL 0
+#define RING_BUFFER_AVX2_KERNEL 0
+#endif
+
+
+static void analyseSpanScalar(const float *pSamples, const unsigned int uNumSamples, float &fPeak, double &dSumOfSquares, int &nOverflows)
+{
+    for (unsigned int uSample = 0; uSample < uNumSamples; uSample++)
+    {
+        float fSampleValue = pSamples[uSample];
+        float fMagnitude = fabsf(fSampleValue);
+
+        if (fMagnitude > fPeak)
+        {
+            fPeak = fMagnitude;
+        }
+
+        dSumOfSquares += fSampleValue * fSampleValue;
+
+        if (fMagnitude > RING_BUFFER_OVERFLOW_LEVEL)
+        {
+            nOverflows++;
+        }
+    }
+}
+
+
+#if RING_BUFFER_SSE2_KERNEL
+
+RING_BUFFER_TARGET_SSE2
+static void analyseSpanSSE2(const float *pSamples, const unsigned int uNumSamples, float &fPeak, double &dSumOfSquares, int &nOverflows)
+{
+    const __m128 vSignMask = _mm_set1_ps(-0.0f);
+    const __m128 vOverflowLevel = _mm_set1_ps(RING_BUFFER_OVERFLOW_LEVEL);
+
+    __m128 vPeak = _mm_set1_ps(fPeak);
+    __m128d vSumLow = _mm_setzero_pd();
+    __m128d vSumHigh = _mm_setzero_pd();
+    __m128i vOverflows = _mm_setzero_si128();
+
+    unsigned int uNumVectors = uNumSamples / 4;
+
+    for (unsigned int uVector = 0; uVector < uNumVectors; uVector++)
+    {
+        __m128 vSamples = _mm_loadu_ps(pSamples + 4 * uVector);
+        __m128 vMagnitudes = _mm_andnot_ps(vSignMask, vSamples);
+
+        // the old peak is the second operand, so NaNs are ignored
+        vPeak = _mm_max_ps(vMagnitudes, vPeak);
+
+        // square in single precision (just like the scalar code),
+        // but accumulate in double precision
+        __m128 vSquares = _mm_mul_ps(vSamples, vSamples);
+        vSumLow = _mm_add_pd(vSumLow, _mm_cvtps_pd(vSquares));
+        vSumHigh = _mm_add_pd(vSumHigh, _mm_cvtps_pd(_mm_movehl_ps(vSquares, vSquares)));
+
+        // comparison yields -1 for every overflow
+        __m128 vIsOverflow = _mm_cmpgt_ps(vMagnitudes, vOverflowLevel);
+        vOverflows = _mm_sub_epi32(vOverflows, _mm_castps_si128(vIsOverflow));
+    }
+
+    float fPeaks[4];
+    double dSums[2];
+    int nCounts[4];
+
+    _mm_storeu_ps(fPeaks, vPeak);
+    _mm_storeu_pd(dSums, _mm_add_pd(vSumLow, vSumHigh));
+    _mm_storeu_si128((__m128i *) nCounts, vOverflows);
+
+    for (int nLane = 0; nLane < 4; nLane++)
+    {
+        if (fPeaks[nLane] > fPeak)
+        {
+            fPeak = fPeaks[nLane];
+        }
+
+        nOverflows += nCounts[nLane];
+    }
+
+    dSumOfSquares += dSums[0] + dSums[1];
+
+    // process remaining samples
+    unsigned int uProcessed = 4 * uNumVectors;
+    analyseSpanScalar(pSamples + uProcessed, uNumSamples - uProcessed, fPeak, dSumOfSquares, nOverflows);
+}
+
+#endif  // RING_BUFFER_SSE2_KERNEL
+
+
+#if RING_BUFFER_AVX2_KERNEL
+
+RING_BUFFER_TARGET_AVX2
+static void analyseSpanAVX2(const float *pSamples, const unsigned int uNumSamples, float &fPeak, double &dSumOfSquares, int &nOverflows)
+{
+    const __m256 vSignMask = _mm256_set1_ps(-0.0f);
+    const __m256 vOverflowLevel = _mm256_set1_ps(RING_BUFFER_OVERFLOW_LEVEL);
+
+    __m256 vPeak = _mm256_set1_ps(fPeak);
+    __m256d vSumLow = _mm256_setzero_pd();
+    __m256d vSumHigh = _mm256_setzero_pd();
+    __m256i vOverflows = _mm256_setzero_si256();
+
+    unsigned int uNumVectors = uNumSamples / 8;
+
+    for (unsigned int uVector = 0; uVector < uNumVectors; uVector++)
+    {
+        __m256 vSamples = _mm256_loadu_ps(pSamples + 8 * uVector);
+        __m256 vMagnitudes = _mm256_andnot_ps(vSignMask, vSamples);
+
+        // the old peak is the second operand, so NaNs are ignored
+        vPeak = _mm256_max_ps(vMagnitudes, vPeak);
+
+        // square in single precision (just like the scalar code),
+        // but accumulate in double precision
+        __m256 vSquares = _mm256_mul_ps(vSamples, vSamples);
+        vSumLow = _mm256_add_pd(vSumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(vSquares)));
+        vSumHigh = _mm256_add_pd(vSumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(vSquares, 1)));
+
+        // comparison yields -1 for every overflow
+        __m256 vIsOverflow = _mm256_cmp_ps(vMagnitudes, vOverflowLevel, _CMP_GT_OQ);
+        vOverflows = _mm256_sub_epi32(vOverflows, _mm256_castps_si256(vIsOverflow));
+    }
+
+    float fPeaks[8];
+    double dSums[4];
+    int nCounts[8];
+
+    _mm256_storeu_ps(fPeaks, vPeak);
+    _mm256_storeu_pd(dSums, _mm256_add_pd(vSumLow, vSumHigh));
+    _mm256_storeu_si256((__m256i *) nCounts, vOverflows);
+
+    for (int nLane = 0; nLane < 8; nLane++)
+    {
+        if (fPeaks[nLane] > fPeak)
+        {
+            fPeak = fPeaks[nLane];
+        }
+
+        nOverflows += nCounts[nLane];
+    }
+
+    dSumOfSquares += (dSums[0] + dSums[1]) + (dSums[2] + dSums[3]);
+
+    // process remaining samples
+    unsigned int uProcessed = 8 * uNumVectors;
+    analyseSpanScalar(pSamples + uProcessed, uNumSamples - uProcessed, fPeak, dSumOfSquares, nOverflows);
+}
+
+#endif  // RING_BUFFER_AVX2_KERNEL
+
+
+static void analyseSpan(const float *pSamples, const unsigned int uNumSamples, float &fPeak, double &dSumOfSquares, int &nOverflows)
+{
+#if RING_BUFFER_AVX2_KERNEL
+    // check processor capabilities only once
+    static const bool bHasAVX2 = __builtin_cpu_supports("avx2");
+    static const bool bHasSSE2 = __builtin_cpu_supports("sse2");
+
+    if (bHasAVX2)
+    {
+        analyseSpanAVX2(pSamples, uNumSamples, fPeak, dSumOfSquares, nOverflows);
+    }
+    else if (bHasSSE2)
+    {
+        analyseSpanSSE2(pSamples, uNumSamples, fPeak, dSumOfSquares, nOverflows);
+    }
+    else
+    {
+        analyseSpanScalar(pSamples, uNumSamples, fPeak, dSumOfSquares, nOverflows);
+    }
+
+#elif RING_BUFFER_SSE2_KERNEL
+    analyseSpanSSE2(pSamples, uNumSamples, fPeak, dSumOfSquares, nOverflows);
+#else
+    analyseSpanScalar(pSamples, uNumSamples, fPeak, dSumOfSquares, nOverflows);
+#endif
+}
+
+
 AudioRingBuffer::AudioRingBuffer(const String &buffer_name, const unsigned int channels, const unsigned int length, const unsigned int pre_delay, const unsigned int chunk_size)
 {
     jassert(channels > 0);
@@ -51,12 +249,15 @@ AudioRingBuffer::AudioRingBuffer(const String &buffer_name, const unsigned int c
 
     uCurrentPosition = 0;
     uSamplesInBuffer = 0;
-    uChannelOffset = new unsigned int[uChannels];
 
-    for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
-    {
-        uChannelOffset[uChannel] = uChannel * (uTotalLength + 2) + 1;
-    }
+    // channels are stored back to back, each one padded with a test
+    // sample on either side
+    uChannelStride = uTotalLength + 2;
+
+    // sliding windows are disabled by default
+    pSlidingWindows = nullptr;
+    uWindowSize = 0;
+    uWindowPreDelay = 0;
 
     this->clear();
 }
@@ -64,31 +265,43 @@ AudioRingBuffer::AudioRingBuffer(const String &buffer_name, const unsigned int c
 
 AudioRingBuffer::~AudioRingBuffer()
 {
-    delete [] uChannelOffset;
-    uChannelOffset = nullptr;
-
     free(pAudioData);
+
+    if (pSlidingWindows)
+    {
+        for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+        {
+            delete [] pSlidingWindows[uChannel].uDequeIndices;
+            delete [] pSlidingWindows[uChannel].fDequeMagnitudes;
+        }
+
+        delete [] pSlidingWindows;
+        pSlidingWindows = nullptr;
+    }
 }
 
 
 void AudioRingBuffer::clear()
 {
     uCurrentPosition = 0;
+    uSamplesInBuffer = 0;
 
     for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
         for (unsigned int uSample = 0; uSample < uTotalLength; uSample++)
         {
-            pAudioData[uSample + uChannelOffset[uChannel]] = 0.0f;
+            getChannelData(uChannel)[uSample] = 0.0f;
         }
 
+    clearSlidingWindows();
+
 #ifdef DEBUG
 
     // detection of memory leaks
     for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
     {
-        jassert(pAudioData[uChannelOffset[uChannel] - 1] == RING_BUFFER_MEM_TEST);
-        jassert(pAudioData[uChannelOffset[uChannel]] != RING_BUFFER_MEM_TEST);
-        jassert(pAudioData[uChannelOffset[uChannel] + uTotalLength] == RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[-1] == RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[0] != RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[uTotalLength] == RING_BUFFER_MEM_TEST);
     }
 
 #endif
@@ -131,6 +344,34 @@ unsigned int AudioRingBuffer::getPreDelay()
 }
 
 
+unsigned int AudioRingBuffer::getChunkSize()
+{
+    return uChunkSize;
+}
+
+
+void AudioRingBuffer::setChunkSize(const unsigned int chunk_size)
+/*  Change the number of samples after which the callback class is
+    notified.  This neither allocates nor touches the audio data, so
+    it may be called on the audio thread.
+
+    chunk_size (unsigned integer): new chunk size
+
+    return value: none
+*/
+{
+    jassert(chunk_size > 0);
+    jassert(chunk_size <= uLength);
+
+    // samples of the current window must not be overwritten before
+    // they have left the window
+    jassert((chunk_size + uWindowSize + uWindowPreDelay) <= uTotalLength);
+
+    uChunkSize = chunk_size;
+    uSamplesInBuffer = 0;
+}
+
+
 float AudioRingBuffer::getSample(const unsigned int channel, const unsigned int relative_position, const unsigned int pre_delay)
 {
     jassert(channel < uChannels);
@@ -151,7 +392,7 @@ float AudioRingBuffer::getSample(const unsigned int channel, const unsigned int
 
     nPosition %= uTotalLength;
 
-    return pAudioData[nPosition + uChannelOffset[channel]];
+    return getChannelData(channel)[nPosition];
 }
 
 
@@ -187,7 +428,12 @@ unsigned int AudioRingBuffer::addSamples(AudioSampleBuffer &source, const unsign
 
         for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
         {
-            memcpy(pAudioData + uCurrentPosition + uChannelOffset[uChannel], source.getReadPointer(uChannel, sourceStartSample + uSamplesFinished), sizeof(float) * uSamplesToCopy);
+            memcpy(getChannelData(uChannel) + uCurrentPosition, source.getReadPointer(uChannel, sourceStartSample + uSamplesFinished), sizeof(float) * uSamplesToCopy);
+        }
+
+        if (pSlidingWindows)
+        {
+            updateSlidingWindows(uCurrentPosition, uSamplesToCopy);
         }
 
         uSamplesInBuffer += uSamplesToCopy;
@@ -215,9 +461,9 @@ unsigned int AudioRingBuffer::addSamples(AudioSampleBuffer &source, const unsign
     // detection of memory leaks
     for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
     {
-        jassert(pAudioData[uChannelOffset[uChannel] - 1] == RING_BUFFER_MEM_TEST);
-        jassert(pAudioData[uChannelOffset[uChannel]] != RING_BUFFER_MEM_TEST);
-        jassert(pAudioData[uChannelOffset[uChannel] + uTotalLength] == RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[-1] == RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[0] != RING_BUFFER_MEM_TEST);
+        jassert(getChannelData(uChannel)[uTotalLength] == RING_BUFFER_MEM_TEST);
     }
 
 #endif
@@ -262,7 +508,7 @@ void AudioRingBuffer::copyToBuffer(AudioSampleBuffer &destination, const unsigne
 
         for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
         {
-            memcpy(destination.getWritePointer(uChannel, destStartSample + uSamplesFinished), pAudioData + nStartPosition + uChannelOffset[uChannel], sizeof(float) * uSamplesToCopy);
+            memcpy(destination.getWritePointer(uChannel, destStartSample + uSamplesFinished), getChannelData(uChannel) + nStartPosition, sizeof(float) * uSamplesToCopy);
         }
 
         nStartPosition += uSamplesToCopy;
@@ -306,7 +552,316 @@ float AudioRingBuffer::getRMSLevel(const unsigned int channel, const unsigned in
 }
 
 
-void AudioRingBuffer::setCallbackClass(TraKmeterAudioProcessor *callback_class)
+void AudioRingBuffer::analyseSamples(const unsigned int channel, const unsigned int numSamples, const unsigned int pre_delay, float &fPeak, double &dSumOfSquares, int &nOverflows)
+/*  Determine peak level, sum of squares and number of overflows in a
+    single pass.
+
+    channel (unsigned integer): selected audio channel
+
+    numSamples (unsigned integer): number of samples to analyse
+
+    pre_delay (unsigned integer): number of most recent samples to
+    skip
+
+    fPeak (reference to float): returns the peak level (linear
+    scale)
+
+    dSumOfSquares (reference to double): returns the sum of squared
+    sample values
+
+    nOverflows (reference to integer): returns the number of overflows
+
+    return value: none
+*/
+{
+    jassert(channel < uChannels);
+    jassert(numSamples <= uLength);
+    jassert(pre_delay <= uPreDelay);
+
+    fPeak = 0.0f;
+    dSumOfSquares = 0.0;
+    nOverflows = 0;
+
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    int nStartPosition = uCurrentPosition - numSamples - pre_delay;
+
+    // make sure "nStartPosition" is positive
+    while (nStartPosition < 0)
+    {
+        nStartPosition += uTotalLength;
+    }
+
+    nStartPosition %= uTotalLength;
+
+    // the samples are stored in (at most) two contiguous spans on
+    // either side of the wrap point
+    unsigned int uSamplesFirstSpan = uTotalLength - nStartPosition;
+
+    if (uSamplesFirstSpan > numSamples)
+    {
+        uSamplesFirstSpan = numSamples;
+    }
+
+    const float *pChannelData = getChannelData(channel);
+
+    analyseSpan(pChannelData + nStartPosition, uSamplesFirstSpan, fPeak, dSumOfSquares, nOverflows);
+    analyseSpan(pChannelData, numSamples - uSamplesFirstSpan, fPeak, dSumOfSquares, nOverflows);
+}
+
+
+void AudioRingBuffer::enableSlidingWindow(const unsigned int window_size, const unsigned int pre_delay)
+/*  Keep running statistics over the last "window_size" samples of
+    every channel, so that peak level, sum of squares and overflows
+    can be read in constant time after each chunk (see
+    "getSlidingWindow()").  This allocates memory and must not be
+    called on the audio thread.
+
+    window_size (unsigned integer): number of samples in window
+
+    pre_delay (unsigned integer): number of most recent samples to
+    skip
+
+    return value: none
+*/
+{
+    jassert(pSlidingWindows == nullptr);
+    jassert(window_size > 0);
+    jassert(pre_delay <= uPreDelay);
+
+    // samples of the current window must not be overwritten before
+    // they have left the window
+    jassert((uChunkSize + window_size + pre_delay) <= uTotalLength);
+
+    uWindowSize = window_size;
+    uWindowPreDelay = pre_delay;
+
+    pSlidingWindows = new SlidingWindow[uChannels];
+
+    for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+    {
+        pSlidingWindows[uChannel].uDequeIndices = new unsigned int[uWindowSize];
+        pSlidingWindows[uChannel].fDequeMagnitudes = new float[uWindowSize];
+    }
+
+    clearSlidingWindows();
+}
+
+
+unsigned int AudioRingBuffer::getSlidingWindowSize()
+{
+    return uWindowSize;
+}
+
+
+void AudioRingBuffer::getSlidingWindow(const unsigned int channel, float &fPeak, double &dSumOfSquares, int &nOverflows)
+/*  Get peak level and sum of squares of the sliding window, and the
+    number of overflows in all samples that have entered the window
+    since the last call of this function.
+
+    channel (unsigned integer): selected audio channel
+
+    fPeak (reference to float): returns the peak level (linear
+    scale)
+
+    dSumOfSquares (reference to double): returns the sum of squared
+    sample values
+
+    nOverflows (reference to integer): returns the number of overflows
+
+    return value: none
+*/
+{
+    jassert(pSlidingWindows != nullptr);
+    jassert(channel < uChannels);
+
+    SlidingWindow &window = pSlidingWindows[channel];
+
+    if (window.uDequeSize > 0)
+    {
+        fPeak = window.fDequeMagnitudes[window.uDequeFront];
+    }
+    else
+    {
+        fPeak = 0.0f;
+    }
+
+    // rounding errors of the running sum might push it below zero
+    dSumOfSquares = (window.dSumOfSquares > 0.0) ? window.dSumOfSquares : 0.0;
+
+    nOverflows = window.nOverflows;
+    window.nOverflows = 0;
+}
+
+
+void AudioRingBuffer::clearSlidingWindows()
+{
+    uWindowSampleIndex = 0;
+    uWindowFreshSamples = 0;
+
+    if (pSlidingWindows == nullptr)
+    {
+        return;
+    }
+
+    for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+    {
+        SlidingWindow &window = pSlidingWindows[uChannel];
+
+        window.dSumOfSquares = 0.0;
+        window.dFreshSumOfSquares = 0.0;
+        window.nOverflows = 0;
+
+        window.uDequeFront = 0;
+        window.uDequeSize = 0;
+    }
+}
+
+
+void AudioRingBuffer::updateSlidingWindows(const unsigned int uStartPosition, const unsigned int uNumSamples)
+/*  Move the sliding windows of all channels by the given number of
+    samples, which have just been written to the ring buffer.
+
+    The running sum of squares is updated by adding the entering and
+    subtracting the leaving sample.  To keep rounding errors from
+    accumulating, the entering samples are also summed up separately;
+    whenever the window has been completely replaced, this exact sum
+    takes over.
+
+    The peak level is tracked with a monotonic deque: every entering
+    sample removes all smaller magnitudes from the back, and samples
+    that have left the window are removed from the front.  Thus every
+    sample is pushed and popped at most once.
+
+    uStartPosition (unsigned integer): buffer position of first new
+    sample
+
+    uNumSamples (unsigned integer): number of new samples
+
+    return value: none
+*/
+{
+    unsigned int uSamplesLeft = uNumSamples;
+
+    // position of first sample that enters the window
+    unsigned int uEnteringStart = (uStartPosition + uTotalLength - uWindowPreDelay) % uTotalLength;
+
+    while (uSamplesLeft > 0)
+    {
+        // stop at the end of the current window to swap sums
+        unsigned int uSamplesToProcess = uWindowSize - uWindowFreshSamples;
+
+        if (uSamplesToProcess > uSamplesLeft)
+        {
+            uSamplesToProcess = uSamplesLeft;
+        }
+
+        unsigned int uLeavingStart = (uEnteringStart + uTotalLength - uWindowSize) % uTotalLength;
+
+        for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+        {
+            const float *pChannelData = getChannelData(uChannel);
+            SlidingWindow &window = pSlidingWindows[uChannel];
+
+            unsigned int uEntering = uEnteringStart;
+            unsigned int uLeaving = uLeavingStart;
+            unsigned int uSampleIndex = uWindowSampleIndex;
+
+            for (unsigned int uSample = 0; uSample < uSamplesToProcess; uSample++)
+            {
+                float fEnteringValue = pChannelData[uEntering];
+                float fLeavingValue = pChannelData[uLeaving];
+
+                // square in single precision (just like
+                // "analyseSamples()"), but accumulate in double
+                // precision
+                double dEnteringSquare = fEnteringValue * fEnteringValue;
+                double dLeavingSquare = fLeavingValue * fLeavingValue;
+
+                window.dSumOfSquares += dEnteringSquare - dLeavingSquare;
+                window.dFreshSumOfSquares += dEnteringSquare;
+
+                float fMagnitude = fabsf(fEnteringValue);
+
+                // ignore NaNs
+                if (!(fMagnitude >= 0.0f))
+                {
+                    fMagnitude = 0.0f;
+                }
+
+                if (fMagnitude > RING_BUFFER_OVERFLOW_LEVEL)
+                {
+                    window.nOverflows++;
+                }
+
+                // remove sample that has left the window
+                if ((window.uDequeSize > 0) && ((uSampleIndex - window.uDequeIndices[window.uDequeFront]) >= uWindowSize))
+                {
+                    window.uDequeFront = (window.uDequeFront + 1) % uWindowSize;
+                    window.uDequeSize--;
+                }
+
+                // remove smaller magnitudes, as they can never become
+                // the peak level again
+                while (window.uDequeSize > 0)
+                {
+                    unsigned int uBack = (window.uDequeFront + window.uDequeSize - 1) % uWindowSize;
+
+                    if (window.fDequeMagnitudes[uBack] > fMagnitude)
+                    {
+                        break;
+                    }
+
+                    window.uDequeSize--;
+                }
+
+                unsigned int uNewBack = (window.uDequeFront + window.uDequeSize) % uWindowSize;
+
+                window.uDequeIndices[uNewBack] = uSampleIndex;
+                window.fDequeMagnitudes[uNewBack] = fMagnitude;
+                window.uDequeSize++;
+
+                uSampleIndex++;
+
+                if (++uEntering == uTotalLength)
+                {
+                    uEntering = 0;
+                }
+
+                if (++uLeaving == uTotalLength)
+                {
+                    uLeaving = 0;
+                }
+            }
+        }
+
+        uWindowSampleIndex += uSamplesToProcess;
+        uWindowFreshSamples += uSamplesToProcess;
+
+        // window has been completely replaced
+        if (uWindowFreshSamples == uWindowSize)
+        {
+            for (unsigned int uChannel = 0; uChannel < uChannels; uChannel++)
+            {
+                SlidingWindow &window = pSlidingWindows[uChannel];
+
+                window.dSumOfSquares = window.dFreshSumOfSquares;
+                window.dFreshSumOfSquares = 0.0;
+            }
+
+            uWindowFreshSamples = 0;
+        }
+
+        uEnteringStart = (uEnteringStart + uSamplesToProcess) % uTotalLength;
+        uSamplesLeft -= uSamplesToProcess;
+    }
+}
+
+
+void AudioRingBuffer::setCallbackClass(AudioRingBufferCallback *callback_class)
 {
     pCallbackClass = callback_class;
 }
@@ -28,10 +28,30 @@
 
 #define RING_BUFFER_MEM_TEST 255.0f
 
+// in the 16-bit domain, full scale corresponds to an absolute integer
+// value of 32'767 or 32'768, so we'll treat absolute levels of 32'767
+// and above as overflows; this corresponds to a floating-point level
+// of 32'767 / 32'768 = 0.9999694 (approx. -0.001 dBFS).
+#define RING_BUFFER_OVERFLOW_LEVEL 0.9999f
+
 class AudioRingBuffer;
 
 #include "JuceHeader.h"
-#include "plugin_processor.h"
+
+
+//==============================================================================
+/**
+   Receives a chunk of audio whenever an AudioRingBuffer has been
+   filled.  Implemented by the audio processor and by the command-line
+   analyser.
+*/
+class AudioRingBufferCallback
+{
+public:
+    virtual ~AudioRingBufferCallback() {}
+
+    virtual void processBufferChunk(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples) = 0;
+};
 
 
 //==============================================================================
@@ -44,7 +64,7 @@ public:
     ~AudioRingBuffer();
 
     void clear();
-    void setCallbackClass(TraKmeterAudioProcessor *callback_class);
+    void setCallbackClass(AudioRingBufferCallback *callback_class);
 
     String getBufferName();
     unsigned int getCurrentPosition();
@@ -53,6 +73,9 @@ public:
     unsigned int getTotalLength();
     unsigned int getPreDelay();
 
+    unsigned int getChunkSize();
+    void setChunkSize(const unsigned int chunk_size);
+
     float getSample(const unsigned int channel, const unsigned int relative_position, const unsigned int pre_delay);
 
     unsigned int addSamples(AudioSampleBuffer &source, const unsigned int sourceStartSample, const unsigned int numSamples);
@@ -61,13 +84,45 @@ public:
     float getMagnitude(const unsigned int channel, const unsigned int numSamples, const unsigned int pre_delay);
     float getRMSLevel(const unsigned int channel, const unsigned int numSamples, const unsigned int pre_delay);
 
+    void analyseSamples(const unsigned int channel, const unsigned int numSamples, const unsigned int pre_delay, float &fPeak, double &dSumOfSquares, int &nOverflows);
+
+    void enableSlidingWindow(const unsigned int window_size, const unsigned int pre_delay);
+    unsigned int getSlidingWindowSize();
+    void getSlidingWindow(const unsigned int channel, float &fPeak, double &dSumOfSquares, int &nOverflows);
+
 private:
     JUCE_LEAK_DETECTOR(AudioRingBuffer);
 
+    // running statistics of one channel over the last "uWindowSize"
+    // samples
+    struct SlidingWindow
+    {
+        double dSumOfSquares;
+        double dFreshSumOfSquares;
+        int nOverflows;
+
+        // monotonic deque of sample magnitudes; the front holds the
+        // peak level of the window
+        unsigned int *uDequeIndices;
+        float *fDequeMagnitudes;
+        unsigned int uDequeFront;
+        unsigned int uDequeSize;
+    };
+
+    void clearSlidingWindows();
+    void updateSlidingWindows(const unsigned int uStartPosition, const unsigned int uNumSamples);
+
+    // channel data is found by multiplication instead of looking up
+    // an offset table
+    inline float *getChannelData(const unsigned int uChannel) const
+    {
+        return pAudioData + uChannel * uChannelStride + 1;
+    }
+
     void clearCallbackClass();
     void triggerFullBuffer(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
 
-    TraKmeterAudioProcessor *pCallbackClass;
+    AudioRingBufferCallback *pCallbackClass;
     String strBufferName;
 
     unsigned int uChannels;
@@ -78,9 +133,15 @@ private:
 
     unsigned int uCurrentPosition;
     unsigned int uSamplesInBuffer;
-    unsigned int *uChannelOffset;
+    unsigned int uChannelStride;
 
     float *pAudioData;
+
+    SlidingWindow *pSlidingWindows;
+    unsigned int uWindowSize;
+    unsigned int uWindowPreDelay;
+    unsigned int uWindowSampleIndex;
+    unsigned int uWindowFreshSamples;
 };
 
 
@@ -179,11 +179,32 @@ void AverageMeter::resized()
 }
 
 
-void AverageMeter::setLevels(MeterBallistics *pMeterBallistics)
+void AverageMeter::setCrestFactor(int CrestFactor)
+/*  Retarget thresholds and scale to a new crest factor in place
+    (without re-creating any components).
+
+    CrestFactor (integer): meter crest factor (0 or 20 dB)
+
+    return value: none
+*/
+{
+    nCrestFactor = CrestFactor;
+
+    for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
+    {
+        LevelMeters[nChannel]->setCrestFactor(nCrestFactor);
+    }
+
+    // re-draw scale
+    repaint();
+}
+
+
+void AverageMeter::setLevels(const MeterSnapshot *pMeterSnapshot)
 {
     for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
     {
-        LevelMeters[nChannel]->setLevels(pMeterBallistics->getAverageMeterLevel(nChannel), pMeterBallistics->getAverageMeterPeakLevel(nChannel));
+        LevelMeters[nChannel]->setLevels(pMeterSnapshot->getAverageMeterLevel(nChannel), pMeterSnapshot->getAverageMeterPeakLevel(nChannel));
     }
 }
 
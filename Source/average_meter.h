@@ -42,7 +42,8 @@ public:
     AverageMeter(const String &componentName, int PosX, int PosY, int width, int CrestFactor, int nNumChannels, int segment_height);
     ~AverageMeter();
 
-    void setLevels(MeterBallistics *pMeterBallistics);
+    void setCrestFactor(int CrestFactor);
+    void setLevels(const MeterSnapshot *pMeterSnapshot);
     void paint(Graphics &g);
     int getPreferredHeight();
     void resized();
@@ -0,0 +1,547 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "batch_analyser.h"
+
+
+BatchAnalyser::BatchAnalyser(int number_of_workers, int crest_factor, bool transient_mode, int hop_divisor, int block_size, bool add_pause)
+/*  Constructor.
+
+    number_of_workers (integer): maximum number of files analysed in
+    parallel
+
+    all other parameters are passed on to AudioFileAnalyser
+
+    return value: none
+*/
+{
+    nNumberOfWorkers = (number_of_workers < 1) ? 1 : number_of_workers;
+    nCrestFactor = crest_factor;
+    bTransientMode = transient_mode;
+    nHopDivisor = hop_divisor;
+    nBlockSize = block_size;
+    bAddPause = add_pause;
+
+    nReportChannel = -1;
+    bReportCSV = false;
+    bReportAverageMeterLevel = true;
+    bReportPeakMeterLevel = true;
+
+    nActiveWorkers = 0;
+
+    pJobs = nullptr;
+    pQueues = nullptr;
+    pQueueLocks = nullptr;
+}
+
+
+BatchAnalyser::~BatchAnalyser()
+{
+    delete [] pJobs;
+    pJobs = nullptr;
+
+    delete [] pQueues;
+    pQueues = nullptr;
+
+    delete [] pQueueLocks;
+    pQueueLocks = nullptr;
+}
+
+
+void BatchAnalyser::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
+{
+    bReportCSV = ReportCSV;
+
+    nReportChannel = nChannel;
+    bReportAverageMeterLevel = bAverageMeterLevel;
+    bReportPeakMeterLevel = bPeakMeterLevel;
+}
+
+
+bool BatchAnalyser::analyseFiles(const Array<File> &audioFiles)
+/*  Analyse audio files in parallel and write their reports to
+    standard output in the given order.  Messages go to standard
+    error when writing CSV, so that the output can be parsed.
+
+    audioFiles (array of File): audio files to analyse
+
+    return value (Boolean): true if all files could be analysed
+*/
+{
+    int nNumberOfJobs = audioFiles.size();
+    nActiveWorkers = jmin(nNumberOfWorkers, nNumberOfJobs);
+
+    delete [] pJobs;
+    delete [] pQueues;
+    delete [] pQueueLocks;
+
+    pJobs = new Job[nNumberOfJobs];
+    pQueues = new Array<int>[nActiveWorkers];
+    pQueueLocks = new CriticalSection[nActiveWorkers];
+
+    // deal out files like cards, so that every worker starts near
+    // the beginning of the list and reports can be written early
+    for (int nJob = 0; nJob < nNumberOfJobs; nJob++)
+    {
+        pJobs[nJob].audioFile = audioFiles[nJob];
+        pJobs[nJob].bSucceeded = false;
+        pJobs[nJob].nSamples = 0;
+
+        // spool reports to disk, so that memory usage does not
+        // depend on the length of the files; in plain text mode,
+        // messages and reports share one log
+        pJobs[nJob].pReportFile = new TemporaryFile(".txt");
+        pJobs[nJob].pMessageStream = bReportCSV ? new MemoryOutputStream() : nullptr;
+
+        pQueues[nJob % nActiveWorkers].add(nJob);
+    }
+
+    double dStartTime = Time::getMillisecondCounterHiRes();
+
+    Worker **pWorkers = new Worker*[nActiveWorkers];
+
+    for (int nWorker = 0; nWorker < nActiveWorkers; nWorker++)
+    {
+        pWorkers[nWorker] = new Worker(this, nWorker);
+        pWorkers[nWorker]->startThread();
+    }
+
+    bool bSucceeded = true;
+    int64 nSamples = 0;
+
+    // write reports in order as soon as they are complete
+    for (int nJob = 0; nJob < nNumberOfJobs; nJob++)
+    {
+        Job *pJob = &pJobs[nJob];
+        pJob->finished.wait();
+
+        if (pJob->pMessageStream)
+        {
+            fwrite(pJob->pMessageStream->getData(), 1, pJob->pMessageStream->getDataSize(), stderr);
+        }
+
+        copyToStandardOutput(pJob->pReportFile->getFile());
+
+        // deletes spooled report
+        delete pJob->pReportFile;
+        pJob->pReportFile = nullptr;
+
+        delete pJob->pMessageStream;
+        pJob->pMessageStream = nullptr;
+
+        bSucceeded = bSucceeded && pJob->bSucceeded;
+        nSamples += pJob->nSamples;
+    }
+
+    for (int nWorker = 0; nWorker < nActiveWorkers; nWorker++)
+    {
+        pWorkers[nWorker]->stopThread(2000);
+
+        delete pWorkers[nWorker];
+        pWorkers[nWorker] = nullptr;
+    }
+
+    delete [] pWorkers;
+    pWorkers = nullptr;
+
+    double dElapsedSeconds = (Time::getMillisecondCounterHiRes() - dStartTime) / 1000.0;
+
+    if (dElapsedSeconds > 0.0)
+    {
+        fprintf(stderr, "Analysed %d file(s) in %.2f s with %d worker(s): %.2f files/s, %.0f samples/s\n",
+                nNumberOfJobs, dElapsedSeconds, nActiveWorkers,
+                nNumberOfJobs / dElapsedSeconds, nSamples / dElapsedSeconds);
+    }
+
+    return bSucceeded;
+}
+
+
+bool BatchAnalyser::getNextJob(int nWorker, int &nJob)
+/*  Get next file for a worker: take it from the front of the
+    worker's own queue or -- if that is empty -- steal it from the
+    back of another worker's queue.
+
+    nWorker (integer): number of the calling worker
+
+    nJob (integer reference): receives number of job
+
+    return value (Boolean): false if there is nothing left to do
+*/
+{
+    {
+        const ScopedLock lock(pQueueLocks[nWorker]);
+
+        if (pQueues[nWorker].size() > 0)
+        {
+            nJob = pQueues[nWorker].getFirst();
+            pQueues[nWorker].remove(0);
+
+            return true;
+        }
+    }
+
+    for (int nOffset = 1; nOffset < nActiveWorkers; nOffset++)
+    {
+        int nVictim = (nWorker + nOffset) % nActiveWorkers;
+        const ScopedLock lock(pQueueLocks[nVictim]);
+
+        if (pQueues[nVictim].size() > 0)
+        {
+            nJob = pQueues[nVictim].getLast();
+            pQueues[nVictim].removeLast();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void BatchAnalyser::runJob(AudioFileAnalyser *pAnalyser, int nJob)
+{
+    Job *pJob = &pJobs[nJob];
+    FileOutputStream *pReportStream = pJob->pReportFile->getFile().createOutputStream();
+
+    if (pReportStream)
+    {
+        OutputStream *pMessageStream = pJob->pMessageStream ? (OutputStream *) pJob->pMessageStream : (OutputStream *) pReportStream;
+
+        pJob->bSucceeded = pAnalyser->analyseFile(pJob->audioFile, pReportStream, pMessageStream);
+        pJob->nSamples = pAnalyser->getSamplesAnalysed();
+
+        // flush and close spooled report
+        delete pReportStream;
+        pReportStream = nullptr;
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: could not create temporary file for \"%s\"\n", pJob->audioFile.getFullPathName().toRawUTF8());
+    }
+
+    pJob->finished.signal();
+}
+
+
+void BatchAnalyser::copyToStandardOutput(const File &fileReport)
+/*  Copy a spooled report to standard output.
+
+    fileReport (File): spooled report
+
+    return value: none
+*/
+{
+    FileInputStream inputStream(fileReport);
+
+    if (inputStream.failedToOpen())
+    {
+        return;
+    }
+
+    HeapBlock<char> pCopyBuffer(nCopyBufferSize);
+
+    while (!inputStream.isExhausted())
+    {
+        int nBytesRead = inputStream.read(pCopyBuffer, nCopyBufferSize);
+
+        if (nBytesRead <= 0)
+        {
+            break;
+        }
+
+        fwrite(pCopyBuffer, 1, nBytesRead, stdout);
+    }
+
+    fflush(stdout);
+}
+
+
+BatchAnalyser::Worker::Worker(BatchAnalyser *batch_analyser, int worker_number) : Thread("Analyser worker " + String(worker_number + 1))
+{
+    pBatchAnalyser = batch_analyser;
+    nWorker = worker_number;
+
+    pAnalyser = new AudioFileAnalyser(pBatchAnalyser->nCrestFactor, pBatchAnalyser->bTransientMode, pBatchAnalyser->nHopDivisor, pBatchAnalyser->nBlockSize, pBatchAnalyser->bAddPause);
+    pAnalyser->setReporters(pBatchAnalyser->nReportChannel, pBatchAnalyser->bReportCSV, pBatchAnalyser->bReportAverageMeterLevel, pBatchAnalyser->bReportPeakMeterLevel);
+}
+
+
+BatchAnalyser::Worker::~Worker()
+{
+    delete pAnalyser;
+    pAnalyser = nullptr;
+}
+
+
+void BatchAnalyser::Worker::run()
+{
+    int nJob;
+
+    while (!threadShouldExit() && pBatchAnalyser->getNextJob(nWorker, nJob))
+    {
+        pBatchAnalyser->runJob(pAnalyser, nJob);
+    }
+}
+
+
+int BatchAnalyser::runCommandLine(const StringArray &arguments)
+/*  Parse command line and analyse all given audio files (and all
+    audio files in the given directories).
+
+    arguments (StringArray): command line arguments (without name of
+    executable)
+
+    return value (integer): exit code
+*/
+{
+    int nCrestFactor = 20;
+    bool bTransientMode = true;
+    int nHopDivisor = 4;
+    int nBlockSize = 512;
+    bool bAddPause = true;
+    int nNumberOfWorkers = SystemStats::getNumCpus();
+
+    int nChannel = -1;
+    bool bReportCSV = false;
+    bool bAverageMeterLevel = true;
+    bool bPeakMeterLevel = true;
+
+    String strRegressionDirectory;
+    bool bUpdateGolden = false;
+    float fTolerance = 0.001f;
+
+    StringArray strFileNames;
+
+    for (int nArgument = 0; nArgument < arguments.size(); nArgument++)
+    {
+        String strArgument = arguments[nArgument];
+
+        if ((strArgument == "--help") || (strArgument == "-h"))
+        {
+            printUsage();
+            return 0;
+        }
+        else if (strArgument == "--csv")
+        {
+            bReportCSV = true;
+        }
+        else if (strArgument == "--averaging")
+        {
+            bTransientMode = false;
+        }
+        else if (strArgument == "--no-pause")
+        {
+            bAddPause = false;
+        }
+        else if (strArgument == "--average-only")
+        {
+            bAverageMeterLevel = true;
+            bPeakMeterLevel = false;
+        }
+        else if (strArgument == "--peak-only")
+        {
+            bAverageMeterLevel = false;
+            bPeakMeterLevel = true;
+        }
+        else if (strArgument.startsWith("--channel="))
+        {
+            // channels are numbered from one, zero selects all
+            nChannel = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue() - 1;
+        }
+        else if (strArgument.startsWith("--crest-factor="))
+        {
+            nCrestFactor = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if ((nCrestFactor != 0) && (nCrestFactor != 20))
+            {
+                fprintf(stderr, "ERROR: crest factor must be 0 or 20 dB\n");
+                return 1;
+            }
+        }
+        else if (strArgument.startsWith("--hop="))
+        {
+            nHopDivisor = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if ((nHopDivisor != 1) && (nHopDivisor != 2) && (nHopDivisor != 4) && (nHopDivisor != 8))
+            {
+                fprintf(stderr, "ERROR: hop divisor must be 1, 2, 4 or 8\n");
+                return 1;
+            }
+        }
+        else if (strArgument.startsWith("--block-size="))
+        {
+            nBlockSize = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if (nBlockSize < 1)
+            {
+                fprintf(stderr, "ERROR: block size must be positive\n");
+                return 1;
+            }
+        }
+        else if (strArgument.startsWith("--jobs="))
+        {
+            nNumberOfWorkers = strArgument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+
+            if (nNumberOfWorkers < 1)
+            {
+                fprintf(stderr, "ERROR: number of jobs must be positive\n");
+                return 1;
+            }
+        }
+        else if (strArgument.startsWith("--regression="))
+        {
+            strRegressionDirectory = strArgument.fromFirstOccurrenceOf("=", false, false);
+        }
+        else if (strArgument == "--update-golden")
+        {
+            bUpdateGolden = true;
+        }
+        else if (strArgument.startsWith("--tolerance="))
+        {
+            fTolerance = strArgument.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+
+            if (fTolerance < 0.0f)
+            {
+                fprintf(stderr, "ERROR: tolerance must not be negative\n");
+                return 1;
+            }
+        }
+        else if (strArgument.startsWith("-"))
+        {
+            fprintf(stderr, "ERROR: unknown option \"%s\"\n", strArgument.toRawUTF8());
+            return 1;
+        }
+        else
+        {
+            strFileNames.add(strArgument);
+        }
+    }
+
+    if (strRegressionDirectory.isNotEmpty())
+    {
+        File validationDirectory = File::getCurrentWorkingDirectory().getChildFile(strRegressionDirectory);
+        return RegressionSuite::run(validationDirectory, bUpdateGolden, fTolerance);
+    }
+
+    if (strFileNames.size() < 1)
+    {
+        printUsage();
+        return 1;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    String strWildcard = formatManager.getWildcardForAllFormats();
+    Array<File> audioFiles;
+
+    for (int nFile = 0; nFile < strFileNames.size(); nFile++)
+    {
+        File fileArgument = File::getCurrentWorkingDirectory().getChildFile(strFileNames[nFile]);
+
+        if (fileArgument.isDirectory())
+        {
+            // sort directory contents, so that reports do not depend
+            // on the file system
+            Array<File> childFiles;
+            fileArgument.findChildFiles(childFiles, File::findFiles, true, strWildcard);
+
+            StringArray strChildFileNames;
+
+            for (int nChild = 0; nChild < childFiles.size(); nChild++)
+            {
+                strChildFileNames.add(childFiles[nChild].getFullPathName());
+            }
+
+            strChildFileNames.sort(true);
+
+            for (int nChild = 0; nChild < strChildFileNames.size(); nChild++)
+            {
+                audioFiles.add(File(strChildFileNames[nChild]));
+            }
+        }
+        else
+        {
+            audioFiles.add(fileArgument);
+        }
+    }
+
+    if (audioFiles.size() < 1)
+    {
+        fprintf(stderr, "ERROR: no audio files found\n");
+        return 1;
+    }
+
+    BatchAnalyser batchAnalyser(nNumberOfWorkers, nCrestFactor, bTransientMode, nHopDivisor, nBlockSize, bAddPause);
+    batchAnalyser.setReporters(nChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel);
+
+    if (batchAnalyser.analyseFiles(audioFiles))
+    {
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+
+void BatchAnalyser::printUsage()
+{
+    fprintf(stderr, "\n"
+            "Usage: trakmeter_analyser [options] file|directory [...]\n"
+            "       trakmeter_analyser --regression=DIR [--update-golden]\n"
+            "                          [--tolerance=DB]\n"
+            "\n"
+            "Runs audio files through the meter faster than realtime and writes\n"
+            "the meter readings of validation mode to standard output.  Files\n"
+            "are analysed in parallel, but reported in the given order.\n"
+            "\n"
+            "  --csv                 write tab-separated values\n"
+            "  --channel=N           only report channel N (default: all)\n"
+            "  --average-only        only report average meter levels\n"
+            "  --peak-only           only report peak meter levels\n"
+            "  --crest-factor=DB     crest factor: 0 or 20 (default: 20)\n"
+            "  --averaging           use averaging instead of transient mode\n"
+            "  --hop=N               hops per analysis window: 1, 2, 4 or 8\n"
+            "                        (default: 4)\n"
+            "  --block-size=N        emulated host block size (default: 512)\n"
+            "  --no-pause            do not append ten seconds of silence\n"
+            "  --jobs=N              number of files analysed in parallel\n"
+            "                        (default: number of CPU cores)\n"
+            "\n"
+            "  --regression=DIR      compare readings of the validation files in\n"
+            "                        DIR with the golden references in DIR/golden\n"
+            "  --update-golden       store current readings as golden references\n"
+            "  --tolerance=DB        maximum difference of readings; 0 checks for\n"
+            "                        bit-exact readings (default: 0.001)\n"
+            "\n");
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
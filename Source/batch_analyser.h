@@ -0,0 +1,118 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __BATCH_ANALYSER_H__
+#define __BATCH_ANALYSER_H__
+
+class BatchAnalyser;
+
+#include "JuceHeader.h"
+#include "audio_file_analyser.h"
+#include "regression_suite.h"
+
+
+//==============================================================================
+/**
+   Analyses many audio files in parallel.  Every worker thread owns an
+   AudioFileAnalyser (and thus its own ring buffer and meter
+   ballistics) and a queue of files; idle workers steal files from
+   the back of other workers' queues.  Reports are spooled per file
+   and written in the original order, so the output does not depend
+   on scheduling.
+*/
+class BatchAnalyser
+{
+public:
+    BatchAnalyser(int number_of_workers, int crest_factor, bool transient_mode, int hop_divisor, int block_size, bool add_pause);
+    ~BatchAnalyser();
+
+    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    bool analyseFiles(const Array<File> &audioFiles);
+
+    static int runCommandLine(const StringArray &arguments);
+
+private:
+    JUCE_LEAK_DETECTOR(BatchAnalyser);
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(BatchAnalyser *batch_analyser, int worker_number);
+        ~Worker();
+
+        void run();
+
+    private:
+        JUCE_LEAK_DETECTOR(Worker);
+
+        BatchAnalyser *pBatchAnalyser;
+        AudioFileAnalyser *pAnalyser;
+        int nWorker;
+    };
+
+    struct Job
+    {
+        File audioFile;
+        bool bSucceeded;
+        int64 nSamples;
+
+        TemporaryFile *pReportFile;
+        MemoryOutputStream *pMessageStream;
+        WaitableEvent finished;
+    };
+
+    // size of buffer for copying spooled reports
+    static const int nCopyBufferSize = 65536;
+
+    int nNumberOfWorkers;
+    int nActiveWorkers;
+    int nCrestFactor;
+    bool bTransientMode;
+    int nHopDivisor;
+    int nBlockSize;
+    bool bAddPause;
+
+    int nReportChannel;
+    bool bReportCSV;
+    bool bReportAverageMeterLevel;
+    bool bReportPeakMeterLevel;
+
+    Job *pJobs;
+    Array<int> *pQueues;
+    CriticalSection *pQueueLocks;
+
+    bool getNextJob(int nWorker, int &nJob);
+    void runJob(AudioFileAnalyser *pAnalyser, int nJob);
+    void copyToStandardOutput(const File &fileReport);
+
+    static void printUsage();
+};
+
+#endif   // __BATCH_ANALYSER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
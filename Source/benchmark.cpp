@@ -0,0 +1,606 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "benchmark.h"
+#include "plugin_processor.h"
+#include "trakmeter.h"
+
+
+Benchmark::Benchmark(int number_of_channels, int block_size, int sample_rate)
+/*  Constructor.  Sets up ring buffer, meter ballistics, dither and
+    meter bars just like the plug-in does.
+
+    number_of_channels (integer): number of audio channels
+
+    block_size (integer): size of host blocks in samples
+
+    sample_rate (integer): sample rate in Hz
+
+    return value: none
+*/
+{
+    nNumberOfChannels = number_of_channels;
+    nBlockSize = block_size;
+    nSampleRate = sample_rate;
+
+    bToggle = false;
+
+    // derive analysis window just like "prepareToPlay()" does
+    uWindowSize = (unsigned int) (TRAKMETER_WINDOW_DURATION * nSampleRate / 1000.0 + 0.5);
+    uPreDelay = uWindowSize / 2;
+
+    unsigned int uHopSize = uWindowSize / 4;
+    unsigned int uRingBufferSize = (nBlockSize > (int) uWindowSize) ? nBlockSize : uWindowSize;
+    uRingBufferSize += uWindowSize;
+
+    pRingBuffer = new AudioRingBuffer("Benchmark ring buffer", nNumberOfChannels, uRingBufferSize, uPreDelay, uHopSize);
+    pRingBuffer->enableSlidingWindow(uWindowSize, uPreDelay);
+
+    pMeterBallistics = new MeterBallistics(nNumberOfChannels, 20, false, false, true);
+    pDither = new Dither(nNumberOfChannels, 24);
+
+    pInputBuffer = new AudioSampleBuffer(nNumberOfChannels, nBlockSize);
+    pOutputBuffer = new AudioSampleBuffer(nNumberOfChannels, nBlockSize);
+
+    // fixed seed, so that all builds process the same signal
+    Random random(42);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        float *fSamples = pInputBuffer->getWritePointer(nChannel);
+
+        for (int nSample = 0; nSample < nBlockSize; nSample++)
+        {
+            fSamples[nSample] = 0.5f * (2.0f * random.nextFloat() - 1.0f);
+        }
+
+        // exercise overflow detection
+        fSamples[0] = 1.0f;
+    }
+
+    pOutputBuffer->makeCopyOf(*pInputBuffer);
+
+    // fill ring buffer, so that all reads hit valid samples
+    int nFillBlocks = (int) uRingBufferSize / nBlockSize + 1;
+
+    for (int nBlock = 0; nBlock < nFillBlocks; nBlock++)
+    {
+        pRingBuffer->addSamples(*pInputBuffer, 0, nBlockSize);
+    }
+
+    pMeterBars = new MeterBarPeak*[nNumberOfChannels];
+
+    fPeakLevels = new float[nNumberOfChannels];
+    fRmsLevels = new float[nNumberOfChannels];
+    nOverflows = new int[nNumberOfChannels];
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        pMeterBars[nChannel] = new MeterBarPeak("Benchmark meter bar", 0, 0, TraKmeter::TRAKMETER_SEGMENT_WIDTH, 20, 20, 10, true, false);
+
+        fPeakLevels[nChannel] = 0.5f;
+        fRmsLevels[nChannel] = 0.25f;
+        nOverflows[nChannel] = 0;
+    }
+}
+
+
+Benchmark::~Benchmark()
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        delete pMeterBars[nChannel];
+        pMeterBars[nChannel] = nullptr;
+    }
+
+    delete [] pMeterBars;
+    pMeterBars = nullptr;
+
+    delete pRingBuffer;
+    pRingBuffer = nullptr;
+
+    delete pMeterBallistics;
+    pMeterBallistics = nullptr;
+
+    delete pDither;
+    pDither = nullptr;
+
+    delete pInputBuffer;
+    pInputBuffer = nullptr;
+
+    delete pOutputBuffer;
+    pOutputBuffer = nullptr;
+
+    delete [] fPeakLevels;
+    fPeakLevels = nullptr;
+
+    delete [] fRmsLevels;
+    fRmsLevels = nullptr;
+
+    delete [] nOverflows;
+    nOverflows = nullptr;
+}
+
+
+const char *Benchmark::getTestCaseName(int nTestCase)
+{
+    switch (nTestCase)
+    {
+    case testRingBufferAddSamples:
+        return "ring_buffer_add_samples";
+    case testRingBufferCopyToBuffer:
+        return "ring_buffer_copy_to_buffer";
+    case testRingBufferGetMagnitude:
+        return "ring_buffer_get_magnitude";
+    case testRingBufferGetRMSLevel:
+        return "ring_buffer_get_rms_level";
+    case testRingBufferAnalyseSamples:
+        return "ring_buffer_analyse_samples";
+    case testMeterBallisticsUpdateChannel:
+        return "meter_ballistics_update_channel";
+    case testMeterBallisticsUpdateAllChannels:
+        return "meter_ballistics_update_all_channels";
+    case testDitherSamples:
+        return "dither_samples";
+    case testMeterBarSetLevels:
+        return "meter_bar_set_levels";
+    default:
+        return "unknown";
+    }
+}
+
+
+void Benchmark::runTestCase(int nTestCase)
+/*  Process one block of audio with the given test case.
+
+    nTestCase (integer): selected test case (see TestCases)
+
+    return value: none
+*/
+{
+    // time passed between two meter updates
+    float fTimePassed = (float) nBlockSize / (float) nSampleRate;
+
+    switch (nTestCase)
+    {
+    case testRingBufferAddSamples:
+
+        pRingBuffer->addSamples(*pInputBuffer, 0, nBlockSize);
+        break;
+
+    case testRingBufferCopyToBuffer:
+
+        pRingBuffer->copyToBuffer(*pOutputBuffer, 0, nBlockSize, uPreDelay);
+        break;
+
+    case testRingBufferGetMagnitude:
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            fPeakLevels[nChannel] = pRingBuffer->getMagnitude(nChannel, uWindowSize, uPreDelay);
+        }
+
+        break;
+
+    case testRingBufferGetRMSLevel:
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            fRmsLevels[nChannel] = pRingBuffer->getRMSLevel(nChannel, uWindowSize, uPreDelay);
+        }
+
+        break;
+
+    case testRingBufferAnalyseSamples:
+
+        // replaces separate calls of getMagnitude(), getRMSLevel()
+        // and the overflow counter
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            double dSumOfSquares;
+            pRingBuffer->analyseSamples(nChannel, uWindowSize, uPreDelay, fPeakLevels[nChannel], dSumOfSquares, nOverflows[nChannel]);
+        }
+
+        break;
+
+    case testMeterBallisticsUpdateChannel:
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            pMeterBallistics->updateChannel(nChannel, fTimePassed, fPeakLevels[nChannel], fRmsLevels[nChannel], nOverflows[nChannel]);
+        }
+
+        break;
+
+    case testMeterBallisticsUpdateAllChannels:
+
+        pMeterBallistics->updateAllChannels(fTimePassed, fPeakLevels, fRmsLevels, nOverflows);
+        break;
+
+    case testDitherSamples:
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            pDither->ditherSamples(nChannel, pOutputBuffer->getWritePointer(nChannel), nBlockSize);
+        }
+
+        break;
+
+    case testMeterBarSetLevels:
+
+        // alternate levels, so that every call changes the bar
+        bToggle = !bToggle;
+
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            pMeterBars[nChannel]->setLevels(bToggle ? -30.0f : -10.0f, bToggle ? -25.0f : -5.0f);
+        }
+
+        break;
+
+    default:
+
+        jassertfalse;
+        break;
+    }
+}
+
+
+void Benchmark::measure(int nTestCase, int nMinimumSamplesPerMeasurement)
+/*  Time a test case and count its allocator calls, then print one
+    line of results.
+
+    nTestCase (integer): selected test case (see TestCases)
+
+    nMinimumSamplesPerMeasurement (integer): minimum number of sample
+    frames to process
+
+    return value: none
+*/
+{
+    for (int nCall = 0; nCall < nWarmUpCalls; nCall++)
+    {
+        runTestCase(nTestCase);
+    }
+
+    int nCalls = jmax(nWarmUpCalls, nMinimumSamplesPerMeasurement / nBlockSize);
+
+    int64 nStartTicks = Time::getHighResolutionTicks();
+
+    for (int nCall = 0; nCall < nCalls; nCall++)
+    {
+        runTestCase(nTestCase);
+    }
+
+    int64 nStopTicks = Time::getHighResolutionTicks();
+
+    double dNanoSecondsPerCall = Time::highResolutionTicksToSeconds(nStopTicks - nStartTicks) * 1e9 / nCalls;
+    double dNanoSecondsPerSample = dNanoSecondsPerCall / nBlockSize;
+
+#ifdef TRAKMETER_REALTIME_AUDIT
+    // count allocator calls separately, as recording them is slow
+    int nAllocationsBefore = RealtimeAudit::getNumberOfViolations(RealtimeAudit::violationAllocation);
+
+    {
+        TRAKMETER_AUDIO_THREAD_SCOPE;
+
+        for (int nCall = 0; nCall < nWarmUpCalls; nCall++)
+        {
+            runTestCase(nTestCase);
+        }
+    }
+
+    int nAllocations = RealtimeAudit::getNumberOfViolations(RealtimeAudit::violationAllocation) - nAllocationsBefore;
+    double dAllocationsPerCall = (double) nAllocations / nWarmUpCalls;
+
+    printf("%s,%d,%d,%d,%d,%.3f,%.4f,%.2f\n", getTestCaseName(nTestCase), nNumberOfChannels, nBlockSize, nSampleRate, nCalls, dNanoSecondsPerCall, dNanoSecondsPerSample, dAllocationsPerCall);
+#else
+    // release builds cannot count allocator calls, so the column is
+    // left out rather than filled with a meaningless value
+    printf("%s,%d,%d,%d,%d,%.3f,%.4f\n", getTestCaseName(nTestCase), nNumberOfChannels, nBlockSize, nSampleRate, nCalls, dNanoSecondsPerCall, dNanoSecondsPerSample);
+#endif
+
+    fflush(stdout);
+}
+
+
+int Benchmark::runCommandLine(const StringArray &arguments)
+/*  Parse command line and run all selected test cases.
+
+    arguments (StringArray): command line arguments (without name of
+    executable)
+
+    return value (integer): exit code
+*/
+{
+    static const int nChannelCounts[] = {2, 8};
+    static const int nSampleRates[] = {44100, 48000, 88200, 96000, 176400, 192000};
+
+    int nMinimumSamplesPerMeasurement = nMinimumSamples;
+    int nNumberOfEditorFrames = nEditorFrames;
+    int nSecondsPerLayout = nAuditSeconds;
+    bool bEditor = false;
+    bool bAudit = false;
+    String strFilter;
+
+    for (int nArgument = 0; nArgument < arguments.size(); nArgument++)
+    {
+        String strArgument = arguments[nArgument];
+
+        if ((strArgument == "--help") || (strArgument == "-h"))
+        {
+            printUsage();
+            return 0;
+        }
+        else if (strArgument == "--quick")
+        {
+            nMinimumSamplesPerMeasurement = nMinimumSamplesQuick;
+            nNumberOfEditorFrames = nEditorFramesQuick;
+            nSecondsPerLayout = nAuditSecondsQuick;
+        }
+        else if (strArgument == "--editor")
+        {
+            bEditor = true;
+        }
+        else if (strArgument == "--audit")
+        {
+            bAudit = true;
+        }
+        else if (strArgument.startsWith("--filter="))
+        {
+            strFilter = strArgument.fromFirstOccurrenceOf("=", false, false);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unknown option \"%s\"\n", strArgument.toRawUTF8());
+            return 1;
+        }
+    }
+
+    // meter bars are components and need the message manager
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    if (bEditor)
+    {
+        return EditorBenchmark::runAll(nNumberOfEditorFrames);
+    }
+
+    if (bAudit)
+    {
+        return runRealtimeAudit(nSecondsPerLayout);
+    }
+
+#ifdef TRAKMETER_REALTIME_AUDIT
+    printf("test_case,channels,block_size,sample_rate,calls,ns_per_call,ns_per_sample,allocations_per_call\n");
+#else
+    printf("test_case,channels,block_size,sample_rate,calls,ns_per_call,ns_per_sample\n");
+#endif
+
+    fflush(stdout);
+
+    for (int nChannelCount = 0; nChannelCount < numElementsInArray(nChannelCounts); nChannelCount++)
+    {
+        for (int nBlockSize = 32; nBlockSize <= 8192; nBlockSize *= 2)
+        {
+            for (int nSampleRate = 0; nSampleRate < numElementsInArray(nSampleRates); nSampleRate++)
+            {
+                Benchmark benchmark(nChannelCounts[nChannelCount], nBlockSize, nSampleRates[nSampleRate]);
+
+                for (int nTestCase = 0; nTestCase < nNumTestCases; nTestCase++)
+                {
+                    if (strFilter.isEmpty() || String(getTestCaseName(nTestCase)).contains(strFilter))
+                    {
+                        benchmark.measure(nTestCase, nMinimumSamplesPerMeasurement);
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+int Benchmark::runRealtimeAudit(int nSecondsPerLayout)
+/*  Run the plug-in's audio callback under the real-time audit for
+    all combinations of channel count, block size and sample rate.
+    Like a host, parameters are changed from the audio thread and the
+    meters are reset from the message thread.  The editor is open, so
+    that meter readings are handed over, too, and the message loop is
+    run after every parameter change.  Writes the number of
+    violations per layout as comma-separated values.
+
+    nSecondsPerLayout (integer): seconds of audio processed per
+    layout
+
+    return value (integer): exit code (non-zero if the audio thread
+    has allocated memory, locked a mutex or made a blocking system
+    call)
+*/
+{
+#ifdef TRAKMETER_REALTIME_AUDIT
+    static const int nChannelCounts[] = {2, 8};
+    static const int nSampleRates[] = {44100, 48000, 88200, 96000, 176400, 192000};
+
+    // automatable parameters and the values they cycle through
+    static const int nParameters[] =
+    {
+        TraKmeterPluginParameters::selTransientMode,
+        TraKmeterPluginParameters::selCrestFactor,
+        TraKmeterPluginParameters::selMixMode,
+        TraKmeterPluginParameters::selGain,
+        TraKmeterPluginParameters::selHopSize
+    };
+
+    static const float fParameterValues[] = {0.0f, 1.0f, 0.5f, 0.25f};
+
+    TraKmeterAudioProcessor *pProcessor = new TraKmeterAudioProcessor();
+    AudioProcessorEditor *pEditor = pProcessor->createEditorIfNeeded();
+    MidiBuffer midiMessages;
+
+    int nParameterChange = 0;
+
+    printf("channels,block_size,sample_rate,blocks,violations\n");
+    fflush(stdout);
+
+    for (int nChannelCount = 0; nChannelCount < numElementsInArray(nChannelCounts); nChannelCount++)
+    {
+        int nNumberOfChannels = nChannelCounts[nChannelCount];
+
+        for (int nBlockSize = 32; nBlockSize <= 8192; nBlockSize *= 2)
+        {
+            for (int nSampleRate = 0; nSampleRate < numElementsInArray(nSampleRates); nSampleRate++)
+            {
+                pProcessor->setPlayConfigDetails(nNumberOfChannels, nNumberOfChannels, nSampleRates[nSampleRate], nBlockSize);
+                pProcessor->prepareToPlay(nSampleRates[nSampleRate], nBlockSize);
+
+                AudioSampleBuffer audioBuffer(nNumberOfChannels, nBlockSize);
+
+                // fixed seed, so that all builds process the same
+                // signal
+                Random random(42);
+
+                int nBlocks = nSecondsPerLayout * nSampleRates[nSampleRate] / nBlockSize + 1;
+                int nViolationsBefore = RealtimeAudit::getNumberOfViolations();
+
+                for (int nBlock = 0; nBlock < nBlocks; nBlock++)
+                {
+                    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+                    {
+                        float *fSamples = audioBuffer.getWritePointer(nChannel);
+
+                        for (int nSample = 0; nSample < nBlockSize; nSample++)
+                        {
+                            fSamples[nSample] = random.nextFloat() - 0.5f;
+                        }
+
+                        // exercise overflow detection
+                        fSamples[0] = 1.0f;
+                    }
+
+                    // the message thread may reset the meters at any
+                    // time
+                    if ((nBlock % (nAuditParameterInterval * 5)) == 0)
+                    {
+                        pProcessor->resetMeters();
+                    }
+
+                    {
+                        TRAKMETER_AUDIO_THREAD_SCOPE;
+
+                        if ((nBlock % nAuditParameterInterval) == 0)
+                        {
+                            int nParameter = nParameters[nParameterChange % numElementsInArray(nParameters)];
+                            float fValue = fParameterValues[(nParameterChange / numElementsInArray(nParameters)) % numElementsInArray(fParameterValues)];
+
+                            pProcessor->setParameter(nParameter, fValue);
+                            nParameterChange++;
+                        }
+
+                        pProcessor->processBlock(audioBuffer, midiMessages);
+                    }
+
+                    // deliver pending messages (and let the editor
+                    // collect parameter changes), so that every
+                    // message posted on the audio thread is recorded
+                    // instead of being merged with earlier ones
+                    if ((nBlock % nAuditParameterInterval) == 0)
+                    {
+                        MessageManager::getInstance()->runDispatchLoopUntil(0);
+                    }
+                }
+
+                int nViolations = RealtimeAudit::getNumberOfViolations() - nViolationsBefore;
+
+                printf("%d,%d,%d,%d,%d\n", nNumberOfChannels, nBlockSize, nSampleRates[nSampleRate], nBlocks, nViolations);
+                fflush(stdout);
+
+                pProcessor->releaseResources();
+            }
+        }
+    }
+
+    delete pEditor;
+    pEditor = nullptr;
+
+    // prints the report of the real-time audit
+    delete pProcessor;
+    pProcessor = nullptr;
+
+    int nNumberOfViolations = RealtimeAudit::getNumberOfViolations();
+
+    if (nNumberOfViolations > 0)
+    {
+        fprintf(stderr, "FAILED: %d violation(s) on the audio thread\n", nNumberOfViolations);
+        return 1;
+    }
+
+    printf("\nNo violations on the audio thread.\n");
+    fflush(stdout);
+
+    return 0;
+#else
+    (void) nSecondsPerLayout;
+
+    fprintf(stderr, "ERROR: the real-time audit is only included in debug builds\n");
+    return 1;
+#endif
+}
+
+
+void Benchmark::printUsage()
+{
+    fprintf(stderr, "\n"
+            "Usage: trakmeter_benchmark [--quick] [--filter=TEXT]\n"
+            "       trakmeter_benchmark --editor [--quick]\n"
+            "       trakmeter_benchmark --audit [--quick]\n"
+            "\n"
+            "Times the hot paths of signal processing and rendering for 2 and 8\n"
+            "channels, block sizes from 32 to 8192 samples and sample rates\n"
+            "from 44.1 to 192 kHz, and writes comma-separated values to standard\n"
+            "output.  Debug builds add the column \"allocations_per_call\",\n"
+            "which counts all calls of the memory allocator (including frees).\n"
+            "\n"
+            "With \"--editor\", the editor is rendered offscreen for stereo and\n"
+            "8-channel layouts in both meter types while scripted level sequences\n"
+            "are played, and time per frame, number of repainted components and\n"
+            "bytes touched are written instead.\n"
+            "\n"
+            "With \"--audit\", the plug-in's audio callback is run for the same\n"
+            "layouts while automatable parameters are changed from the audio\n"
+            "thread.  The exit code is non-zero if the audio thread allocated\n"
+            "memory, locked a mutex or made a blocking system call.\n"
+            "\n"
+            "  --quick               process fewer samples per measurement\n"
+            "  --filter=TEXT         only run test cases whose name contains TEXT\n"
+            "  --editor              run editor rendering benchmark\n"
+            "  --audit               run real-time audit of the audio callback\n"
+            "\n");
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
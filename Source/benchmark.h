@@ -0,0 +1,132 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include "JuceHeader.h"
+#include "audio_ring_buffer.h"
+#include "dither.h"
+#include "editor_benchmark.h"
+#include "meter_ballistics.h"
+#include "meter_bar_peak.h"
+#include "realtime_audit.h"
+
+
+//==============================================================================
+/**
+   Micro-benchmarks for the hot paths of signal processing and
+   rendering.  Every test case is run for all combinations of channel
+   count, block size and sample rate, and the results are written to
+   standard output as comma-separated values (time per call and per
+   sample frame), so that builds can be compared.
+
+   Debug builds also report calls of the memory allocator per call,
+   which are counted with the real-time audit.  It is only enabled in
+   debug builds of the benchmark project (see "premake4.lua"), so
+   that release builds are timed without its hooks and leave out the
+   "allocations_per_call" column.  The audit also drives the plug-in's
+   audio callback and fails on any violation (see
+   "runRealtimeAudit").
+*/
+class Benchmark
+{
+public:
+    enum TestCases
+    {
+        testRingBufferAddSamples = 0,
+        testRingBufferCopyToBuffer,
+        testRingBufferGetMagnitude,
+        testRingBufferGetRMSLevel,
+        testRingBufferAnalyseSamples,
+        testMeterBallisticsUpdateChannel,
+        testMeterBallisticsUpdateAllChannels,
+        testDitherSamples,
+        testMeterBarSetLevels,
+
+        nNumTestCases
+    };
+
+    Benchmark(int number_of_channels, int block_size, int sample_rate);
+    ~Benchmark();
+
+    void runTestCase(int nTestCase);
+
+    static const char *getTestCaseName(int nTestCase);
+    static int runCommandLine(const StringArray &arguments);
+    static int runRealtimeAudit(int nSecondsPerLayout);
+
+private:
+    JUCE_LEAK_DETECTOR(Benchmark);
+
+    // minimum number of sample frames processed per measurement
+    static const int nMinimumSamples = 4194304;
+    static const int nMinimumSamplesQuick = 262144;
+
+    // number of frames rendered per editor benchmark
+    static const int nEditorFrames = 300;
+    static const int nEditorFramesQuick = 60;
+
+    // number of calls used for warming up caches and for counting
+    // allocator calls
+    static const int nWarmUpCalls = 16;
+
+    // seconds of audio processed per layout by the real-time audit
+    static const int nAuditSeconds = 4;
+    static const int nAuditSecondsQuick = 1;
+
+    // blocks between parameter changes during the real-time audit
+    static const int nAuditParameterInterval = 7;
+
+    int nNumberOfChannels;
+    int nBlockSize;
+    int nSampleRate;
+
+    unsigned int uWindowSize;
+    unsigned int uPreDelay;
+
+    bool bToggle;
+
+    AudioSampleBuffer *pInputBuffer;
+    AudioSampleBuffer *pOutputBuffer;
+    AudioRingBuffer *pRingBuffer;
+    MeterBallistics *pMeterBallistics;
+    Dither *pDither;
+    MeterBarPeak **pMeterBars;
+
+    float *fPeakLevels;
+    float *fRmsLevels;
+    int *nOverflows;
+
+    void measure(int nTestCase, int nMinimumSamplesPerMeasurement);
+    static void printUsage();
+};
+
+#endif   // __BENCHMARK_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
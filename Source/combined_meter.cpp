@@ -220,13 +220,42 @@ void CombinedMeter::resized()
 }
 
 
-void CombinedMeter::setLevels(MeterBallistics *pMeterBallistics)
+void CombinedMeter::setCrestFactor(int CrestFactor)
+/*  Retarget thresholds and scale to a new crest factor in place
+    (without re-creating any components).
+
+    CrestFactor (integer): meter crest factor (0 or 20 dB)
+
+    return value: none
+*/
+{
+    nCrestFactor = CrestFactor;
+
+    int nThreshold = -90;
+    nThreshold += nCrestFactor * 10;
+
+    // register all hot signals, even up to +100 dB FS!
+    float fRange = ((nCrestFactor * 10) - nThreshold) * 0.1f + 100.0f;
+
+    for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
+    {
+        AverageMeters[nChannel]->setCrestFactor(nCrestFactor);
+        PeakMeters[nChannel]->setCrestFactor(nCrestFactor);
+        MeterSegmentOverloads[nChannel]->setThresholds(nThreshold * 0.1f, fRange, nCrestFactor);
+    }
+
+    // re-draw scale
+    repaint();
+}
+
+
+void CombinedMeter::setLevels(const MeterSnapshot *pMeterSnapshot)
 {
     for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
     {
-        AverageMeters[nChannel]->setLevels(pMeterBallistics->getAverageMeterLevel(nChannel), pMeterBallistics->getAverageMeterPeakLevel(nChannel));
-        PeakMeters[nChannel]->setLevels(pMeterBallistics->getPeakMeterLevel(nChannel), pMeterBallistics->getPeakMeterPeakLevel(nChannel));
-        MeterSegmentOverloads[nChannel]->setLevels(pMeterBallistics->getPeakMeterLevel(nChannel), pMeterBallistics->getPeakMeterPeakLevel(nChannel), pMeterBallistics->getMaximumPeakLevel(nChannel));
+        AverageMeters[nChannel]->setLevels(pMeterSnapshot->getAverageMeterLevel(nChannel), pMeterSnapshot->getAverageMeterPeakLevel(nChannel));
+        PeakMeters[nChannel]->setLevels(pMeterSnapshot->getPeakMeterLevel(nChannel), pMeterSnapshot->getPeakMeterPeakLevel(nChannel));
+        MeterSegmentOverloads[nChannel]->setLevels(pMeterSnapshot->getPeakMeterLevel(nChannel), pMeterSnapshot->getPeakMeterPeakLevel(nChannel), pMeterSnapshot->getMaximumPeakLevel(nChannel));
     }
 }
 
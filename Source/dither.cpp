@@ -25,12 +25,30 @@
 
 #include "dither.h"
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define DITHER_SSE2 1
+#include <emmintrin.h>
+#else
+#define DITHER_SSE2 0
+#endif
+
 // Thanks to Paul Kellet from mda for the code snippet!
 // (http://www.musicdsp.org/showone.php?id=77)
 
 
-Dither::Dither(int number_of_bits, double noise_shaping)
+Dither::Dither(int number_of_channels, int number_of_bits, double noise_shaping)
 {
+    jassert(number_of_channels > 0);
+
+    nNumberOfChannels = number_of_channels;
+
+    uRandomState.allocate(nNumberOfChannels * 4, true);
+    nRandomNumbers.allocate(nRandomBlockSize, true);
+
+    nRandomNumber_1.allocate(nNumberOfChannels, true);
+    dErrorFeedback_1.allocate(nNumberOfChannels, true);
+    dErrorFeedback_2.allocate(nNumberOfChannels, true);
+
     initialise(number_of_bits, noise_shaping);
 }
 
@@ -45,13 +63,30 @@ void Dither::initialise(int number_of_bits, double noise_shaping)
 {
     jassert(number_of_bits <= 24);
 
-    // rectangular-PDF random numbers
-    nRandomNumber_1 = 0;
-    nRandomNumber_2 = 0;
-
-    // error feedback buffers
-    dErrorFeedback_1 = 0.0;
-    dErrorFeedback_2 = 0.0;
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        // seed generators with different non-zero values (this is
+        // the finaliser of MurmurHash3)
+        for (int nLane = 0; nLane < 4; nLane++)
+        {
+            uint32 uSeed = (uint32)(nChannel * 4 + nLane + 1);
+
+            uSeed ^= uSeed >> 16;
+            uSeed *= 0x85EBCA6Bu;
+            uSeed ^= uSeed >> 13;
+            uSeed *= 0xC2B2AE35u;
+            uSeed ^= uSeed >> 16;
+
+            uRandomState[nChannel * 4 + nLane] = (uSeed != 0) ? uSeed : 0x9E3779B9u;
+        }
+
+        // rectangular-PDF random numbers
+        nRandomNumber_1[nChannel] = 0;
+
+        // error feedback buffers
+        dErrorFeedback_1[nChannel] = 0.0;
+        dErrorFeedback_2[nChannel] = 0.0;
+    }
 
     // set to 0.0 for no noise shaping
     dNoiseShaping = noise_shaping;
@@ -60,43 +95,129 @@ void Dither::initialise(int number_of_bits, double noise_shaping)
     dWordLength = pow(2.0, number_of_bits - 1);
     dWordLengthInverted = 1.0 / dWordLength;
 
-    // dither amplitude (2 LSB)
-    dDitherAmplitude = dWordLengthInverted / RAND_MAX;
+    // dither amplitude (2 LSB); random numbers range from 0 to
+    // 0x7FFFFFFF
+    dDitherAmplitude = dWordLengthInverted / 0x7FFFFFFF;
 
     // remove DC offset
     dDcOffset = dWordLengthInverted * 0.5;
 }
 
 
+void Dither::generateRandomNumbers(int nChannel, int nNumSamples)
+/*  Fill "nRandomNumbers" with rectangular-PDF random numbers from the
+    xorshift generators of a channel (Marsaglia, 2003).
+
+    nChannel (integer): audio channel
 
-float Dither::dither(double dInput)
+    nNumSamples (integer): number of random numbers to generate (will
+    be rounded up to a multiple of four)
+
+    return value: none
+*/
 {
-    // can make HP-TRI dither by subtracting previous rand()
-    nRandomNumber_2 = nRandomNumber_1;
-    nRandomNumber_1 = rand();
+    jassert(nNumSamples <= nRandomBlockSize);
+
+    uint32 *pState = uRandomState + nChannel * 4;
 
-    // error feedback
-    double dOutput = dInput + dNoiseShaping * (dErrorFeedback_1 + dErrorFeedback_1 - dErrorFeedback_2);
+#if DITHER_SSE2
+    __m128i vState = _mm_loadu_si128((const __m128i *) pState);
 
-    // DC offset and dither
-    double dTmp = dOutput + dDcOffset + dDitherAmplitude * (double)(nRandomNumber_1 - nRandomNumber_2);
+    for (int nSample = 0; nSample < nNumSamples; nSample += 4)
+    {
+        vState = _mm_xor_si128(vState, _mm_slli_epi32(vState, 13));
+        vState = _mm_xor_si128(vState, _mm_srli_epi32(vState, 17));
+        vState = _mm_xor_si128(vState, _mm_slli_epi32(vState, 5));
+
+        // use the upper 31 bits, so that the numbers are positive
+        _mm_storeu_si128((__m128i *)(nRandomNumbers + nSample), _mm_srli_epi32(vState, 1));
+    }
 
-    // truncate downwards
-    int nOutputTruncate = (int)(dWordLength * dTmp);
+    _mm_storeu_si128((__m128i *) pState, vState);
+#else
 
-    if (dTmp < 0.0)
+    for (int nSample = 0; nSample < nNumSamples; nSample += 4)
     {
-        // this is faster than floor()
-        nOutputTruncate--;
+        for (int nLane = 0; nLane < 4; nLane++)
+        {
+            uint32 uState = pState[nLane];
+
+            uState ^= uState << 13;
+            uState ^= uState >> 17;
+            uState ^= uState << 5;
+
+            pState[nLane] = uState;
+
+            // use the upper 31 bits, so that the numbers are positive
+            nRandomNumbers[nSample + nLane] = (int)(uState >> 1);
+        }
     }
 
-    // old error feedback
-    dErrorFeedback_2 = dErrorFeedback_1;
+#endif
+}
+
+
+void Dither::ditherSamples(int nChannel, float *fSamples, int nNumSamples)
+/*  Dither samples of an audio channel in place.
+
+    nChannel (integer): audio channel (selects dither state)
+
+    fSamples (float array): audio samples
+
+    nNumSamples (integer): number of samples
+
+    return value: none
+*/
+{
+    jassert(nChannel >= 0);
+    jassert(nChannel < nNumberOfChannels);
+
+    // keep state in local variables, as the error feedback loop
+    // cannot be vectorised
+    int nRandom_1 = nRandomNumber_1[nChannel];
+    double dFeedback_1 = dErrorFeedback_1[nChannel];
+    double dFeedback_2 = dErrorFeedback_2[nChannel];
+
+    for (int nStart = 0; nStart < nNumSamples; nStart += nRandomBlockSize)
+    {
+        int nBlockSize = jmin(nNumSamples - nStart, nRandomBlockSize);
+        generateRandomNumbers(nChannel, nBlockSize);
+
+        for (int nSample = 0; nSample < nBlockSize; nSample++)
+        {
+            // can make HP-TRI dither by subtracting previous random
+            // number
+            int nRandom_2 = nRandom_1;
+            nRandom_1 = nRandomNumbers[nSample];
+
+            // error feedback
+            double dOutput = fSamples[nStart + nSample] + dNoiseShaping * (dFeedback_1 + dFeedback_1 - dFeedback_2);
+
+            // DC offset and dither
+            double dTmp = dOutput + dDcOffset + dDitherAmplitude * ((double) nRandom_1 - (double) nRandom_2);
+
+            // truncate downwards
+            int nOutputTruncate = (int)(dWordLength * dTmp);
 
-    // new error feedback
-    dErrorFeedback_1 = dOutput - dWordLengthInverted * (double) nOutputTruncate;
+            if (dTmp < 0.0)
+            {
+                // this is faster than floor()
+                nOutputTruncate--;
+            }
+
+            // old error feedback
+            dFeedback_2 = dFeedback_1;
+
+            // new error feedback
+            dFeedback_1 = dOutput - dWordLengthInverted * (double) nOutputTruncate;
+
+            fSamples[nStart + nSample] = (float) dOutput;
+        }
+    }
 
-    return (float) dOutput;
+    nRandomNumber_1[nChannel] = nRandom_1;
+    dErrorFeedback_1[nChannel] = dFeedback_1;
+    dErrorFeedback_2[nChannel] = dFeedback_2;
 }
 
 
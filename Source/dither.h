@@ -31,24 +31,37 @@
 
 //==============================================================================
 /**
+   Noise-shaped TPDF dither with separate state for every channel, so
+   that the dither noise of different channels is not correlated.
+   Random numbers come from four interleaved xorshift generators per
+   channel, which are computed in parallel using SSE2 (if available).
 */
 class Dither
 {
 public:
-    Dither(int number_of_bits, double noise_shaping = 0.5);
+    Dither(int number_of_channels, int number_of_bits, double noise_shaping = 0.5);
     ~Dither();
 
     void initialise(int number_of_bits, double noise_shaping = 0.5);
-    float dither(double input);
+    void ditherSamples(int nChannel, float *fSamples, int nNumSamples);
 
 private:
     JUCE_LEAK_DETECTOR(Dither);
 
-    int nRandomNumber_1;
-    int nRandomNumber_2;
+    // random numbers are generated in blocks of this size
+    static const int nRandomBlockSize = 256;
 
-    double dErrorFeedback_1;
-    double dErrorFeedback_2;
+    void generateRandomNumbers(int nChannel, int nNumSamples);
+
+    int nNumberOfChannels;
+
+    // four generator states per channel
+    HeapBlock<uint32> uRandomState;
+    HeapBlock<int> nRandomNumbers;
+
+    HeapBlock<int> nRandomNumber_1;
+    HeapBlock<double> dErrorFeedback_1;
+    HeapBlock<double> dErrorFeedback_2;
 
     double dDcOffset;
     double dDitherAmplitude;
@@ -0,0 +1,361 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "editor_benchmark.h"
+
+
+EditorBenchmark::EditorBenchmark(int number_of_channels, int meter_type) : random(42)
+/*  Constructor.  Creates processor and editor for the given layout.
+
+    number_of_channels (integer): number of audio channels
+
+    meter_type (integer): meter type (see TraKmeterPluginParameters)
+
+    return value: none
+*/
+{
+    nNumberOfChannels = number_of_channels;
+    nMeterType = meter_type;
+    dPhase = 0.0;
+
+    pProcessor = new TraKmeterAudioProcessor();
+    pProcessor->setPlayConfigDetails(nNumberOfChannels, nNumberOfChannels, nSampleRate, nBlockSize);
+
+    float fMeterType = float(nMeterType) / (TraKmeterPluginParameters::nNumMeterTypes - 1.0f);
+    pProcessor->setParameter(TraKmeterPluginParameters::selMeterType, fMeterType);
+    pProcessor->prepareToPlay(nSampleRate, nBlockSize);
+
+    pEditor = pProcessor->createEditor();
+    pAudioBuffer = new AudioSampleBuffer(nNumberOfChannels, nBlockSize);
+    fGains = new float[nNumberOfChannels];
+
+    imageFrame = Image(Image::ARGB, pEditor->getWidth(), pEditor->getHeight(), true);
+    collectLeafComponents(pEditor);
+
+    for (int nLeaf = 0; nLeaf < leafComponents.size(); nLeaf++)
+    {
+        leafSnapshots.add(Image::null);
+        updateLeafSnapshot(nLeaf);
+    }
+}
+
+
+EditorBenchmark::~EditorBenchmark()
+{
+    delete pEditor;
+    pEditor = nullptr;
+
+    pProcessor->releaseResources();
+
+    delete pProcessor;
+    pProcessor = nullptr;
+
+    delete pAudioBuffer;
+    pAudioBuffer = nullptr;
+
+    delete [] fGains;
+    fGains = nullptr;
+}
+
+
+const char *EditorBenchmark::getScriptName(int nScript)
+{
+    switch (nScript)
+    {
+    case scriptSilence:
+        return "silence";
+    case scriptRamp:
+        return "ramp";
+    case scriptTransients:
+        return "transients";
+    default:
+        return "unknown";
+    }
+}
+
+
+void EditorBenchmark::collectLeafComponents(Component *pComponent)
+/*  Collect all visible components without children.  Their parents
+    are painted whenever a leaf is repainted, as they lie underneath.
+
+    pComponent (pointer to Component): root of component tree
+
+    return value: none
+*/
+{
+    if (!pComponent->isVisible())
+    {
+        return;
+    }
+
+    if (pComponent->getNumChildComponents() == 0)
+    {
+        leafComponents.add(pComponent);
+        return;
+    }
+
+    for (int nChild = 0; nChild < pComponent->getNumChildComponents(); nChild++)
+    {
+        collectLeafComponents(pComponent->getChildComponent(nChild));
+    }
+}
+
+
+bool EditorBenchmark::updateLeafSnapshot(int nLeaf)
+/*  Render a leaf component on its own and compare with the previous
+    rendering.
+
+    nLeaf (integer): selected leaf component
+
+    return value (Boolean): true if the component looks different
+*/
+{
+    Component *pLeaf = leafComponents[nLeaf];
+
+    if (pLeaf->getWidth() <= 0 || pLeaf->getHeight() <= 0)
+    {
+        return false;
+    }
+
+    Image imageNew = pLeaf->createComponentSnapshot(pLeaf->getLocalBounds(), false);
+    Image imageOld = leafSnapshots[nLeaf];
+
+    bool bChanged = true;
+
+    if (imageOld.isValid() && (imageOld.getBounds() == imageNew.getBounds()) && (imageOld.getFormat() == imageNew.getFormat()))
+    {
+        Image::BitmapData bitmapOld(imageOld, Image::BitmapData::readOnly);
+        Image::BitmapData bitmapNew(imageNew, Image::BitmapData::readOnly);
+
+        int nBytesPerLine = bitmapNew.width * bitmapNew.pixelStride;
+        bChanged = false;
+
+        for (int nLine = 0; nLine < bitmapNew.height; nLine++)
+        {
+            if (memcmp(bitmapOld.getLinePointer(nLine), bitmapNew.getLinePointer(nLine), (size_t) nBytesPerLine) != 0)
+            {
+                bChanged = true;
+                break;
+            }
+        }
+    }
+
+    leafSnapshots.set(nLeaf, imageNew);
+    return bChanged;
+}
+
+
+float EditorBenchmark::getScriptLevel(int nScript, int nFrame, int nChannel)
+/*  Get level of the test signal.
+
+    return value (float): level in decibel
+*/
+{
+    switch (nScript)
+    {
+    case scriptRamp:
+    {
+        // sweep from -60 to 0 dB in four seconds, channels offset by
+        // 3 dB
+        int nFramesPerRamp = 4 * nFramesPerSecond;
+        float fLevel = -60.0f + 60.0f * (nFrame % nFramesPerRamp) / nFramesPerRamp;
+
+        return fLevel - 3.0f * nChannel;
+    }
+
+    case scriptTransients:
+
+        // new random level on every channel in every frame
+        return -40.0f * random.nextFloat();
+
+    default:
+
+        return MeterBallistics::getMeterMinimumDecibel();
+    }
+}
+
+
+void EditorBenchmark::processFrame(int nScript, int nFrame)
+/*  Run one frame of the test signal (a sine wave with scripted levels)
+    through the processor.
+
+    return value: none
+*/
+{
+    int nSamplesPerFrame = nSampleRate / nFramesPerSecond;
+    double dPhaseIncrement = 2.0 * double_Pi * 1000.0 / nSampleRate;
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fGains[nChannel] = MeterBallistics::decibel2level(getScriptLevel(nScript, nFrame, nChannel));
+    }
+
+    for (int nStart = 0; nStart < nSamplesPerFrame; nStart += nBlockSize)
+    {
+        int nSamples = jmin(nBlockSize, nSamplesPerFrame - nStart);
+        pAudioBuffer->setSize(nNumberOfChannels, nSamples, false, false, true);
+
+        for (int nSample = 0; nSample < nSamples; nSample++)
+        {
+            float fSine = (float) sin(dPhase);
+            dPhase += dPhaseIncrement;
+
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                pAudioBuffer->setSample(nChannel, nSample, fGains[nChannel] * fSine);
+            }
+        }
+
+        pProcessor->processBlock(*pAudioBuffer, midiBuffer);
+    }
+}
+
+
+void EditorBenchmark::run(int nScript, int nNumberOfFrames)
+/*  Run a script and print one line of results.
+
+    nScript (integer): selected script (see Scripts)
+
+    nNumberOfFrames (integer): number of frames to render
+
+    return value: none
+*/
+{
+    TraKmeterAudioProcessorEditor *pTraKmeterEditor = dynamic_cast<TraKmeterAudioProcessorEditor *>(pEditor);
+    jassert(pTraKmeterEditor != nullptr);
+
+    double dUpdateSeconds = 0.0;
+    double dPaintSeconds = 0.0;
+    int64 nRepaintedComponents = 0;
+    int64 nBytesTouched = 0;
+
+    for (int nFrame = 0; nFrame < nNumberOfFrames; nFrame++)
+    {
+        processFrame(nScript, nFrame);
+
+        // hand new meter readings to the editor (this is where
+        // components decide whether they need to be repainted)
+        int64 nStartTicks = Time::getHighResolutionTicks();
+        pTraKmeterEditor->metersUpdated();
+        dUpdateSeconds += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - nStartTicks);
+
+        // find changed components (not timed)
+        RectangleList<int> dirtyRegion;
+
+        for (int nLeaf = 0; nLeaf < leafComponents.size(); nLeaf++)
+        {
+            if (updateLeafSnapshot(nLeaf))
+            {
+                Component *pLeaf = leafComponents[nLeaf];
+                dirtyRegion.add(pEditor->getLocalArea(pLeaf, pLeaf->getLocalBounds()));
+
+                nRepaintedComponents++;
+            }
+        }
+
+        if (dirtyRegion.isEmpty())
+        {
+            continue;
+        }
+
+        dirtyRegion.consolidate();
+
+        // frame buffers hold four bytes per pixel
+        for (const Rectangle<int> *pRectangle = dirtyRegion.begin(); pRectangle != dirtyRegion.end(); pRectangle++)
+        {
+            nBytesTouched += (int64) pRectangle->getWidth() * pRectangle->getHeight() * 4;
+        }
+
+        // redraw dirty region just like a window would
+        nStartTicks = Time::getHighResolutionTicks();
+        {
+            Graphics g(imageFrame);
+            g.reduceClipRegion(dirtyRegion);
+            pEditor->paintEntireComponent(g, false);
+        }
+        dPaintSeconds += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - nStartTicks);
+    }
+
+    // the host may redraw the whole editor (e.g. when it is exposed)
+    int nFullPaints = 10;
+    int64 nStartTicks = Time::getHighResolutionTicks();
+
+    for (int nPaint = 0; nPaint < nFullPaints; nPaint++)
+    {
+        Graphics g(imageFrame);
+        pEditor->paintEntireComponent(g, false);
+    }
+
+    double dFullPaintSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - nStartTicks) / nFullPaints;
+
+    printf("%d,%s,%s,%d,%d,%.2f,%.2f,%.2f,%.1f,%.0f\n",
+           nNumberOfChannels,
+           (nMeterType == TraKmeterPluginParameters::selSeparateMeters) ? "separate" : "combined",
+           getScriptName(nScript),
+           nNumberOfFrames,
+           leafComponents.size(),
+           dUpdateSeconds * 1e6 / nNumberOfFrames,
+           dPaintSeconds * 1e6 / nNumberOfFrames,
+           dFullPaintSeconds * 1e6,
+           (double) nRepaintedComponents / nNumberOfFrames,
+           (double) nBytesTouched / nNumberOfFrames);
+
+    fflush(stdout);
+}
+
+
+int EditorBenchmark::runAll(int nNumberOfFrames)
+/*  Run all scripts for stereo and 8-channel layouts in both meter
+    types.  The caller must have initialised the GUI classes.
+
+    nNumberOfFrames (integer): number of frames per script
+
+    return value (integer): exit code
+*/
+{
+    static const int nChannelCounts[] = {2, 8};
+
+    printf("channels,meter_type,script,frames,components,update_us_per_frame,paint_us_per_frame,full_paint_us,repainted_components_per_frame,bytes_touched_per_frame\n");
+    fflush(stdout);
+
+    for (int nChannelCount = 0; nChannelCount < numElementsInArray(nChannelCounts); nChannelCount++)
+    {
+        for (int nMeterType = 0; nMeterType < TraKmeterPluginParameters::nNumMeterTypes; nMeterType++)
+        {
+            for (int nScript = 0; nScript < nNumScripts; nScript++)
+            {
+                EditorBenchmark editorBenchmark(nChannelCounts[nChannelCount], nMeterType);
+                editorBenchmark.run(nScript, nNumberOfFrames);
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
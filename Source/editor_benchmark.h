@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __EDITOR_BENCHMARK_H__
+#define __EDITOR_BENCHMARK_H__
+
+#include "JuceHeader.h"
+#include "plugin_editor.h"
+#include "plugin_parameters.h"
+#include "plugin_processor.h"
+
+
+//==============================================================================
+/**
+   Measures the paint cost of the plug-in editor without a window.
+   Scripted level sequences are run through the processor, the editor
+   is updated once per frame, and every component that changed is
+   rendered into an offscreen image, just like a window would redraw
+   its dirty region.  Results are written to standard output as
+   comma-separated values.
+*/
+class EditorBenchmark
+{
+public:
+    enum Scripts
+    {
+        scriptSilence = 0,
+        scriptRamp,
+        scriptTransients,
+
+        nNumScripts
+    };
+
+    EditorBenchmark(int number_of_channels, int meter_type);
+    ~EditorBenchmark();
+
+    void run(int nScript, int nNumberOfFrames);
+
+    static const char *getScriptName(int nScript);
+    static int runAll(int nNumberOfFrames);
+
+private:
+    JUCE_LEAK_DETECTOR(EditorBenchmark);
+
+    // frames per second of a typical editor refresh
+    static const int nFramesPerSecond = 30;
+
+    static const int nSampleRate = 44100;
+    static const int nBlockSize = 512;
+
+    int nNumberOfChannels;
+    int nMeterType;
+
+    TraKmeterAudioProcessor *pProcessor;
+    AudioProcessorEditor *pEditor;
+    AudioSampleBuffer *pAudioBuffer;
+    MidiBuffer midiBuffer;
+    float *fGains;
+
+    Image imageFrame;
+    Array<Component *> leafComponents;
+    Array<Image> leafSnapshots;
+
+    Random random;
+    double dPhase;
+
+    void collectLeafComponents(Component *pComponent);
+    bool updateLeafSnapshot(int nLeaf);
+    void processFrame(int nScript, int nFrame);
+    float getScriptLevel(int nScript, int nFrame, int nChannel);
+};
+
+#endif   // __EDITOR_BENCHMARK_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,173 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "frame_scheduler.h"
+
+
+FrameScheduler::FrameScheduler()
+{
+    nFrameRate = nDefaultFrameRate;
+    nSubFrames = 1;
+    nTick = 0;
+
+    bServingClients = false;
+    bClientsChanged = false;
+}
+
+
+FrameScheduler::~FrameScheduler()
+{
+    stopTimer();
+
+    // all clients should have unregistered by now
+    jassert(clients.size() == 0);
+}
+
+
+void FrameScheduler::addClient(Client *client)
+{
+    clients.addIfNotAlreadyThere(client);
+
+    // the sub-frames of a running loop must not change
+    if (bServingClients)
+    {
+        bClientsChanged = true;
+        return;
+    }
+
+    restartTimer();
+}
+
+
+void FrameScheduler::removeClient(Client *client)
+{
+    int nIndex = clients.indexOf(client);
+
+    if (nIndex < 0)
+    {
+        return;
+    }
+
+    // keep the indices of a running loop; the client is removed once
+    // the loop has finished
+    if (bServingClients)
+    {
+        clients.set(nIndex, nullptr);
+        bClientsChanged = true;
+        return;
+    }
+
+    clients.remove(nIndex);
+    restartTimer();
+}
+
+
+void FrameScheduler::setFrameRate(int nFramesPerSecond)
+/*  Set target frame rate of all clients.
+
+    nFramesPerSecond (integer): frames per second (1 to 120)
+
+    return value: none
+*/
+{
+    nFrameRate = jlimit(1, 120, nFramesPerSecond);
+    restartTimer();
+}
+
+
+int FrameScheduler::getFrameRate()
+{
+    return nFrameRate;
+}
+
+
+void FrameScheduler::restartTimer()
+{
+    if (clients.size() == 0)
+    {
+        stopTimer();
+        return;
+    }
+
+    // a single client does not need any sub-frames
+    nSubFrames = jmin(clients.size(), nMaximumSubFrames);
+    nTick = 0;
+
+    int nIntervalMilliseconds = roundToInt(1000.0 / (nFrameRate * nSubFrames));
+    startTimer(jmax(1, nIntervalMilliseconds));
+}
+
+
+void FrameScheduler::timerCallback()
+{
+    int nSubFrame = nTick % nSubFrames;
+    int nFrame = nTick / nSubFrames;
+
+    nTick++;
+
+    // prevent overflow (and keep the hidden frame divider in step)
+    if (nTick >= nSubFrames * nHiddenFrameDivider)
+    {
+        nTick = 0;
+    }
+
+    bool bServeHiddenClients = (nFrame == 0);
+
+    // clients that register while being served will be served from
+    // the next frame on
+    int nNumberOfClients = clients.size();
+    bServingClients = true;
+
+    for (int nClient = nSubFrame; nClient < nNumberOfClients; nClient += nSubFrames)
+    {
+        Client *client = clients[nClient];
+
+        // client has unregistered while being served
+        if (client == nullptr)
+        {
+            continue;
+        }
+
+        if (bServeHiddenClients || client->isFrameVisible())
+        {
+            client->frameTick();
+        }
+    }
+
+    bServingClients = false;
+
+    if (bClientsChanged)
+    {
+        bClientsChanged = false;
+
+        clients.removeAllInstancesOf(nullptr);
+        restartTimer();
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,101 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __FRAME_SCHEDULER_H__
+#define __FRAME_SCHEDULER_H__
+
+#include "JuceHeader.h"
+
+
+//==============================================================================
+/**
+   Drives the redraws of all open editors from a single timer, so
+   that the redraw rate no longer depends on the sample rate.  Obtain
+   the scheduler through "SharedResourcePointer" so that all plugin
+   instances in a process share it.
+
+   Every frame is split into sub-frames, and clients are spread over
+   these to avoid bursts.  Clients that are not showing (such as
+   minimised editors) are only served every few frames.  All
+   functions must be called from the message thread.
+
+   The frame rate is shared by all editors in a process.  Only the
+   stand-alone application reads it from its settings ("frameRate");
+   plug-ins always use the default frame rate.
+*/
+class FrameScheduler : public Timer
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() {}
+
+        virtual void frameTick() = 0;
+        virtual bool isFrameVisible() = 0;
+    };
+
+    FrameScheduler();
+    ~FrameScheduler();
+
+    void addClient(Client *client);
+    void removeClient(Client *client);
+
+    void setFrameRate(int nFramesPerSecond);
+    int getFrameRate();
+
+    void timerCallback();
+
+    static const int nDefaultFrameRate = 30;
+
+private:
+    JUCE_LEAK_DETECTOR(FrameScheduler);
+
+    // maximum number of sub-frames per frame
+    static const int nMaximumSubFrames = 4;
+
+    // clients that are not showing are served every n-th frame
+    static const int nHiddenFrameDivider = 6;
+
+    void restartTimer();
+
+    Array<Client *> clients;
+
+    int nFrameRate;
+    int nSubFrames;
+    int nTick;
+
+    // clients may register or unregister while they are being served
+    bool bServingClients;
+    bool bClientsChanged;
+};
+
+
+#endif  // __FRAME_SCHEDULER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,323 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "golden_reference.h"
+
+
+GoldenReference::GoldenReference()
+{
+    clear();
+}
+
+
+GoldenReference::~GoldenReference()
+{
+}
+
+
+void GoldenReference::clear()
+{
+    nNumberOfChannels = 0;
+    dSampleRate = 0.0;
+
+    nCheckpointPositions.clear();
+    fReadings.clear();
+}
+
+
+void GoldenReference::copyCheckpointsFrom(const GoldenReference &reference)
+/*  Measure at the same positions as another reference.  Stored
+    readings are discarded.
+
+    reference (GoldenReference): reference to copy positions from
+
+    return value: none
+*/
+{
+    clear();
+    nCheckpointPositions = reference.nCheckpointPositions;
+}
+
+
+void GoldenReference::prepare(int number_of_channels, int64 nNumberOfSamples, double sample_rate)
+/*  Prepare for storing readings.  If no checkpoints have been
+    defined, add one for every second of audio.
+
+    number_of_channels (integer): number of audio channels
+
+    nNumberOfSamples (64-bit integer): number of samples that will be
+    analysed
+
+    sample_rate (double): sample rate of audio file
+
+    return value: none
+*/
+{
+    nNumberOfChannels = number_of_channels;
+    dSampleRate = sample_rate;
+
+    if (nCheckpointPositions.size() == 0)
+    {
+        int64 nInterval = (int64) dSampleRate;
+
+        for (int64 nPosition = nInterval; nPosition <= nNumberOfSamples; nPosition += nInterval)
+        {
+            nCheckpointPositions.add(nPosition);
+        }
+    }
+
+    int nNumberOfValues = nCheckpointPositions.size() * nNumberOfChannels * nNumberOfReadings;
+
+    fReadings.clearQuick();
+    fReadings.insertMultiple(0, MeterBallistics::getMeterMinimumDecibel(), nNumberOfValues);
+}
+
+
+int GoldenReference::getNumberOfCheckpoints() const
+{
+    return nCheckpointPositions.size();
+}
+
+
+int64 GoldenReference::getCheckpointPosition(int nCheckpoint) const
+/*  Get position of a checkpoint.  Checkpoints are sorted by position.
+
+    nCheckpoint (integer): selected checkpoint
+
+    return value (64-bit integer): position in samples
+*/
+{
+    return nCheckpointPositions[nCheckpoint];
+}
+
+
+void GoldenReference::storeReadings(int nCheckpoint, MeterBallistics *pMeterBallistics)
+/*  Store current meter readings of all channels.
+
+    nCheckpoint (integer): selected checkpoint
+
+    pMeterBallistics (pointer to MeterBallistics): meter readings
+
+    return value: none
+*/
+{
+    jassert(nCheckpoint >= 0);
+    jassert(nCheckpoint < nCheckpointPositions.size());
+    jassert(pMeterBallistics->getNumberOfChannels() == nNumberOfChannels);
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        int nIndex = (nCheckpoint * nNumberOfChannels + nChannel) * nNumberOfReadings;
+
+        fReadings.set(nIndex + readingPeakMeter, pMeterBallistics->getPeakMeterLevel(nChannel));
+        fReadings.set(nIndex + readingAverageMeter, pMeterBallistics->getAverageMeterLevel(nChannel));
+        fReadings.set(nIndex + readingSignalMeter, pMeterBallistics->getPeakMeterSignal(nChannel));
+    }
+}
+
+
+float GoldenReference::getReading(int nCheckpoint, int nChannel, int nReading) const
+{
+    return fReadings[(nCheckpoint * nNumberOfChannels + nChannel) * nNumberOfReadings + nReading];
+}
+
+
+bool GoldenReference::loadFromFile(const File &fileReference)
+/*  Load golden reference.  Every line holds position (in samples),
+    channel (counted from one) and the readings of peak meter, average
+    meter and signal meter in decibel; empty lines and lines starting
+    with "#" are ignored.
+
+    fileReference (File): file to load
+
+    return value (Boolean): true if the file could be parsed
+*/
+{
+    clear();
+
+    if (!fileReference.existsAsFile())
+    {
+        return false;
+    }
+
+    StringArray strLines;
+    fileReference.readLines(strLines);
+
+    Array<float> fLoadedReadings;
+
+    for (int nLine = 0; nLine < strLines.size(); nLine++)
+    {
+        String strLine = strLines[nLine].trim();
+
+        if (strLine.isEmpty() || strLine.startsWithChar('#'))
+        {
+            continue;
+        }
+
+        StringArray strTokens;
+        strTokens.addTokens(strLine, " \t", String::empty);
+        strTokens.removeEmptyStrings();
+
+        if (strLine.startsWith("sample_rate"))
+        {
+            dSampleRate = strTokens[1].getDoubleValue();
+            continue;
+        }
+
+        if (strTokens.size() != 2 + nNumberOfReadings)
+        {
+            clear();
+            return false;
+        }
+
+        int64 nPosition = strTokens[0].getLargeIntValue();
+        int nChannel = strTokens[1].getIntValue() - 1;
+
+        // a new checkpoint starts with the first channel
+        if (nChannel == 0)
+        {
+            nCheckpointPositions.add(nPosition);
+        }
+        else if ((nCheckpointPositions.size() == 0) || (nPosition != nCheckpointPositions.getLast()))
+        {
+            clear();
+            return false;
+        }
+
+        // the first checkpoint defines the number of channels
+        if (nCheckpointPositions.size() == 1)
+        {
+            nNumberOfChannels = nChannel + 1;
+        }
+
+        for (int nReading = 0; nReading < nNumberOfReadings; nReading++)
+        {
+            fLoadedReadings.add((float) strTokens[2 + nReading].getDoubleValue());
+        }
+    }
+
+    fReadings = fLoadedReadings;
+
+    // every checkpoint must hold readings of all channels
+    if ((nNumberOfChannels == 0) || (fReadings.size() != nCheckpointPositions.size() * nNumberOfChannels * nNumberOfReadings))
+    {
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool GoldenReference::saveToFile(const File &fileReference, const String &strDescription) const
+/*  Save readings as golden reference.
+
+    fileReference (File): file to write (will be overwritten)
+
+    strDescription (String): description written to the file header
+
+    return value (Boolean): true if the file could be written
+*/
+{
+    String strOutput;
+
+    strOutput << "# traKmeter golden reference\n";
+    strOutput << "# " << strDescription << "\n";
+    strOutput << "#\n";
+    strOutput << "sample_rate " << String(dSampleRate, 1) << "\n";
+    strOutput << "#\n";
+    strOutput << "# position  channel  peak  average  signal\n";
+
+    for (int nCheckpoint = 0; nCheckpoint < nCheckpointPositions.size(); nCheckpoint++)
+    {
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            strOutput << String(nCheckpointPositions[nCheckpoint]) << " " << String(nChannel + 1);
+
+            for (int nReading = 0; nReading < nNumberOfReadings; nReading++)
+            {
+                strOutput << " " << String((double) getReading(nCheckpoint, nChannel, nReading), 9);
+            }
+
+            strOutput << "\n";
+        }
+    }
+
+    fileReference.getParentDirectory().createDirectory();
+    return fileReference.replaceWithText(strOutput);
+}
+
+
+int GoldenReference::compareWith(const GoldenReference &reference, float fTolerance, StringArray &strMismatches) const
+/*  Compare readings with a golden reference.
+
+    reference (GoldenReference): golden reference
+
+    fTolerance (float): maximum difference of readings in decibel;
+    zero checks for bit-exact readings
+
+    strMismatches (StringArray): descriptions of all mismatches are
+    appended to this array
+
+    return value (integer): number of mismatches
+*/
+{
+    static const char *strReadingNames[nNumberOfReadings] = {"peak", "average", "signal"};
+
+    if ((nNumberOfChannels != reference.nNumberOfChannels) || (nCheckpointPositions != reference.nCheckpointPositions))
+    {
+        strMismatches.add("number of channels or checkpoints differs from golden reference");
+        return 1;
+    }
+
+    int nMismatches = 0;
+
+    for (int nCheckpoint = 0; nCheckpoint < nCheckpointPositions.size(); nCheckpoint++)
+    {
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            for (int nReading = 0; nReading < nNumberOfReadings; nReading++)
+            {
+                float fReading = getReading(nCheckpoint, nChannel, nReading);
+                float fExpected = reference.getReading(nCheckpoint, nChannel, nReading);
+
+                if (fabs(fReading - fExpected) > fTolerance)
+                {
+                    double dSeconds = nCheckpointPositions[nCheckpoint] / reference.dSampleRate;
+
+                    strMismatches.add(String(dSeconds, 3) + " s, channel " + String(nChannel + 1) + ", " + strReadingNames[nReading] + ": " + String(fReading, 6) + " dB (expected " + String(fExpected, 6) + " dB)");
+                    nMismatches++;
+                }
+            }
+        }
+    }
+
+    return nMismatches;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
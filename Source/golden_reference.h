@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __GOLDEN_REFERENCE_H__
+#define __GOLDEN_REFERENCE_H__
+
+class GoldenReference;
+
+#include "JuceHeader.h"
+#include "meter_ballistics.h"
+
+
+//==============================================================================
+/**
+   Meter readings (peak meter, average meter and signal meter level of
+   every channel) at defined positions of an audio file.  Stored
+   readings serve as golden reference for regression tests of the
+   metering pipeline.
+
+   Readings are saved with nine decimal places, which is enough to
+   restore every float exactly, so that a tolerance of zero checks for
+   bit-exact results.
+*/
+class GoldenReference
+{
+public:
+    GoldenReference();
+    ~GoldenReference();
+
+    void clear();
+    void copyCheckpointsFrom(const GoldenReference &reference);
+    void prepare(int number_of_channels, int64 nNumberOfSamples, double dSampleRate);
+
+    int getNumberOfCheckpoints() const;
+    int64 getCheckpointPosition(int nCheckpoint) const;
+    void storeReadings(int nCheckpoint, MeterBallistics *pMeterBallistics);
+
+    bool loadFromFile(const File &fileReference);
+    bool saveToFile(const File &fileReference, const String &strDescription) const;
+
+    int compareWith(const GoldenReference &reference, float fTolerance, StringArray &strMismatches) const;
+
+private:
+    JUCE_LEAK_DETECTOR(GoldenReference);
+
+    enum Readings
+    {
+        readingPeakMeter = 0,
+        readingAverageMeter,
+        readingSignalMeter,
+
+        nNumberOfReadings
+    };
+
+    int nNumberOfChannels;
+    double dSampleRate;
+
+    Array<int64> nCheckpointPositions;
+    Array<float> fReadings;
+
+    float getReading(int nCheckpoint, int nChannel, int nReading) const;
+};
+
+#endif   // __GOLDEN_REFERENCE_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
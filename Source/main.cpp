@@ -32,6 +32,44 @@ START_JUCE_APPLICATION(StandaloneApplication)
 
 #endif
 
+// build command-line analyser
+#ifdef TRAKMETER_ANALYSER
+
+#include "batch_analyser.h"
+
+int main(int argc, char *argv[])
+{
+    StringArray arguments;
+
+    for (int nArgument = 1; nArgument < argc; nArgument++)
+    {
+        arguments.add(String::fromUTF8(argv[nArgument]));
+    }
+
+    return BatchAnalyser::runCommandLine(arguments);
+}
+
+#endif
+
+// build micro-benchmarks
+#ifdef TRAKMETER_BENCHMARK
+
+#include "benchmark.h"
+
+int main(int argc, char *argv[])
+{
+    StringArray arguments;
+
+    for (int nArgument = 1; nArgument < argc; nArgument++)
+    {
+        arguments.add(String::fromUTF8(argv[nArgument]));
+    }
+
+    return Benchmark::runCommandLine(arguments);
+}
+
+#endif
+
 // build VST plugin
 #if defined (TRAKMETER_VST_PLUGIN) || defined (TRAKMETER_LV2_PLUGIN)
 
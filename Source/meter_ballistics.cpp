@@ -25,6 +25,13 @@
 
 #include "meter_ballistics.h"
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define METER_BALLISTICS_SSE2 1
+#include <emmintrin.h>
+#else
+#define METER_BALLISTICS_SSE2 0
+#endif
+
 
 // RMS peak-to-average gain correction; this is simply the difference
 // between peak and average meter readings during validation, measured
@@ -58,34 +65,67 @@ MeterBallistics::MeterBallistics(int nChannels, int CrestFactor, bool bPeakMeter
     // store the number of audio input channels
     nNumberOfChannels = nChannels;
 
+    // pad number of channels for SIMD processing
+    nPaddedChannels = (nNumberOfChannels + METER_BALLISTICS_CHANNEL_PADDING - 1) / METER_BALLISTICS_CHANNEL_PADDING * METER_BALLISTICS_CHANNEL_PADDING;
+
     // store meter's crest factor
     setCrestFactor(CrestFactor);
 
     // store setting for transient mode
     bTransientMode = transient_mode;
 
-    // allocate variables for peak meter's level and peak mark (all
-    // audio input channels)
-    fPeakMeterLevels = new float[nNumberOfChannels];
-    fPeakMeterPeakLevels = new float[nNumberOfChannels];
-
-    // allocate variables for average meter's level and peak mark (all
-    // audio input channels)
-    fAverageMeterLevels = new float[nNumberOfChannels];
-    fAverageMeterPeakLevels = new float[nNumberOfChannels];
-
-    // allocate variables for the time since the peak mark was last
-    // changed (all audio input channels)
-    fPeakMeterPeakLastChanged = new float[nNumberOfChannels];
-    fAverageMeterPeakLastChanged = new float[nNumberOfChannels];
+    // allocate one block for all channel state; "new" does not
+    // guarantee the alignment of the arrays, so allocate some extra
+    // memory and align them by hand
+    const int nNumberOfArrays = 11;
+    size_t uArraySize = nPaddedChannels * sizeof(float);
+
+    pStateMemory.allocate(nNumberOfArrays * uArraySize + METER_BALLISTICS_ALIGNMENT, true);
+
+    pointer_sized_int nAddress = reinterpret_cast<pointer_sized_int>(pStateMemory.getData());
+    nAddress = (nAddress + METER_BALLISTICS_ALIGNMENT - 1) & ~((pointer_sized_int) METER_BALLISTICS_ALIGNMENT - 1);
+    char *pArray = reinterpret_cast<char *>(nAddress);
+
+    // variables for peak meter's level and peak mark (all audio input
+    // channels)
+    fPeakMeterLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+    fPeakMeterPeakLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+
+    // variables for average meter's level and peak mark (all audio
+    // input channels)
+    fAverageMeterLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+    fAverageMeterPeakLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+
+    // variables for the time since the peak mark was last changed
+    // (all audio input channels)
+    fPeakMeterPeakLastChanged = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+    fAverageMeterPeakLastChanged = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+
+    // variables for peak meter signal level
+    fPeakMeterSignals = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+
+    // variables for overall maximum peak level and number of
+    // registered overflows (all audio input channels)
+    fMaximumPeakLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+    nNumberOfOverflows = reinterpret_cast<int *>(pArray);
+    pArray += uArraySize;
 
-    // allocate variables for peak meter signal level
-    fPeakMeterSignals = new float[nNumberOfChannels];
+    // variables for input levels of "updateAllChannels"
+    fCurrentPeakLevels = reinterpret_cast<float *>(pArray);
+    pArray += uArraySize;
+    fCurrentAverageLevels = reinterpret_cast<float *>(pArray);
 
-    // allocate variables for overall maximum peak level and number of
-    // registered overflows (all audio input channels)
-    fMaximumPeakLevels = new float[nNumberOfChannels];
-    nNumberOfOverflows = new int[nNumberOfChannels];
+    // make sure that coefficients are calculated on first update
+    fCoefficientsTimePassed = -1.0f;
+    updateCoefficients(0.0f);
 
     // select "infinite peak hold" or "falling peaks" mode
     setPeakMeterInfiniteHold(bPeakMeterInfiniteHold);
@@ -102,33 +142,7 @@ MeterBallistics::~MeterBallistics()
     return value: none
 */
 {
-    // delete all allocated variables
-    delete [] fPeakMeterLevels;
-    fPeakMeterLevels = nullptr;
-
-    delete [] fPeakMeterPeakLevels;
-    fPeakMeterPeakLevels = nullptr;
-
-    delete [] fAverageMeterLevels;
-    fAverageMeterLevels = nullptr;
-
-    delete [] fAverageMeterPeakLevels;
-    fAverageMeterPeakLevels = nullptr;
-
-    delete [] fPeakMeterPeakLastChanged;
-    fPeakMeterPeakLastChanged = nullptr;
-
-    delete [] fAverageMeterPeakLastChanged;
-    fAverageMeterPeakLastChanged = nullptr;
-
-    delete [] fPeakMeterSignals;
-    fPeakMeterSignals = nullptr;
-
-    delete [] fMaximumPeakLevels;
-    fMaximumPeakLevels = nullptr;
-
-    delete [] nNumberOfOverflows;
-    nNumberOfOverflows = nullptr;
+    // all variables live in "pStateMemory", which frees itself
 }
 
 
@@ -138,8 +152,8 @@ void MeterBallistics::reset()
     return value: none
 */
 {
-    // loop through all audio channels
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    // loop through all audio channels (including padding)
+    for (int nChannel = 0; nChannel < nPaddedChannels; nChannel++)
     {
         // set peak meter's level and peak mark to meter's minimum
         fPeakMeterLevels[nChannel] = fMeterMinimumDecibel;
@@ -170,8 +184,8 @@ void MeterBallistics::setPeakMeterInfiniteHold(bool bInfiniteHold)
     return value: none
 */
 {
-    // loop through all audio channels
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    // loop through all audio channels (including padding)
+    for (int nChannel = 0; nChannel < nPaddedChannels; nChannel++)
     {
         // negative times will not be processed by meter ballistics,
         // so this effectively selects "infinite peak hold" mode
@@ -198,8 +212,8 @@ void MeterBallistics::setAverageMeterInfiniteHold(bool bInfiniteHold)
     return value: none
 */
 {
-    // loop through all audio channels
-    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    // loop through all audio channels (including padding)
+    for (int nChannel = 0; nChannel < nPaddedChannels; nChannel++)
     {
         // negative times will not be processed by meter ballistics,
         // so this effectively selects "infinite peak hold" mode
@@ -250,6 +264,31 @@ void MeterBallistics::setCrestFactor(int CrestFactor)
 }
 
 
+bool MeterBallistics::getTransientMode()
+/*  Get current average meter ballistics.
+
+    return value (Boolean): returns true for "transient mode" and
+    false for "averaging mode"
+*/
+{
+    return bTransientMode;
+}
+
+
+void MeterBallistics::setTransientMode(bool transient_mode)
+/*  Set average meter ballistics.  Meter readings are retained, so the
+    meter simply continues with the new ballistics.
+
+    transient_mode (Boolean): selects "transient mode" (true) or
+    "averaging mode" (false) for average meter
+
+    return value: none
+*/
+{
+    bTransientMode = transient_mode;
+}
+
+
 float MeterBallistics::getPeakMeterLevel(int nChannel)
 /*  Get current level of an audio channel's peak level meter.
 
@@ -382,6 +421,8 @@ void MeterBallistics::updateChannel(int nChannel, float fTimePassed, float fPeak
     jassert(nChannel >= 0);
     jassert(nChannel < nNumberOfChannels);
 
+    updateCoefficients(fTimePassed);
+
     // convert current peak meter level from linear scale to decibels
     fPeak = level2decibel(fPeak);
 
@@ -398,14 +439,14 @@ void MeterBallistics::updateChannel(int nChannel, float fTimePassed, float fPeak
 
     // apply peak meter's ballistics and store resulting level and
     // peak mark
-    fPeakMeterLevels[nChannel] = PeakMeterBallistics(fTimePassed, fPeak, fPeakMeterLevels[nChannel]);
+    fPeakMeterLevels[nChannel] = PeakMeterBallistics(fPeak, fPeakMeterLevels[nChannel]);
     fPeakMeterPeakLevels[nChannel] = PeakMeterPeakBallistics(fTimePassed, &fPeakMeterPeakLastChanged[nChannel], fPeak, fPeakMeterPeakLevels[nChannel]);
 
-    PeakMeterSignalBallistics(nChannel, fTimePassed, fPeak);
+    PeakMeterSignalBallistics(nChannel, fPeak);
 
     // apply average meter's ballistics and store resulting level and
     // peak mark
-    AverageMeterBallistics(nChannel, fTimePassed, fRms);
+    AverageMeterBallistics(nChannel, fRms);
     fAverageMeterPeakLevels[nChannel] = AverageMeterPeakBallistics(fTimePassed, &fAverageMeterPeakLastChanged[nChannel], fAverageMeterLevels[nChannel], fAverageMeterPeakLevels[nChannel]);
 
     // update registered number of overflows
@@ -413,6 +454,321 @@ void MeterBallistics::updateChannel(int nChannel, float fTimePassed, float fPeak
 }
 
 
+void MeterBallistics::updateAllChannels(float fTimePassed, const float *fPeaks, const float *fRmsLevels, const int *nOverflows)
+/*  Update audio levels, overflows and apply meter ballistics for all
+    channels at once.  Applies the same ballistics as "updateChannel",
+    but converts levels with "levels2decibels" instead of
+    "level2decibel".  Unless METER_BALLISTICS_FAST_LOG is set to 0,
+    readings may thus differ from those of "updateChannel" by up to
+    0.00002 dB, but never light different segments.
+
+    fTimePassed (float): time that has passed since last update (in
+    fractional seconds)
+
+    fPeaks (float array): current peak meter levels (linear scale)
+
+    fRmsLevels (float array): current RMS levels (linear scale)
+
+    nOverflows (integer array): number of overflows in buffer chunk
+
+    return value: none
+*/
+{
+    // the channel count of the build is known at compile time, so
+    // meters of the plug-in get kernels with fully unrolled channel
+    // loops (other channel counts, e.g. in the analyser, use the
+    // generic kernels)
+    if (nPaddedChannels == METER_BALLISTICS_BUILD_CHANNELS)
+    {
+        updateAllChannelsFixed<METER_BALLISTICS_BUILD_CHANNELS>(fTimePassed, fPeaks, fRmsLevels, nOverflows);
+    }
+    else
+    {
+        updateAllChannelsFixed<0>(fTimePassed, fPeaks, fRmsLevels, nOverflows);
+    }
+}
+
+
+template <int nFixedChannels>
+void MeterBallistics::updateAllChannelsFixed(float fTimePassed, const float *fPeaks, const float *fRmsLevels, const int *nOverflows)
+/*  Implementation of "updateAllChannels" for a padded channel count
+    known at compile time ("nFixedChannels"; 0 selects the channel
+    count of the meter).
+
+    fTimePassed (float): time that has passed since last update (in
+    fractional seconds)
+
+    fPeaks (float array): current peak meter levels (linear scale)
+
+    fRmsLevels (float array): current RMS levels (linear scale)
+
+    nOverflows (integer array): number of overflows in buffer chunk
+
+    return value: none
+*/
+{
+    const int nChannels = (nFixedChannels > 0) ? nFixedChannels : nPaddedChannels;
+    jassert(nChannels == nPaddedChannels);
+
+    updateCoefficients(fTimePassed);
+
+    for (int nChannel = 0; nChannel < nChannels; nChannel++)
+    {
+        if (nChannel < nNumberOfChannels)
+        {
+            fCurrentPeakLevels[nChannel] = fPeaks[nChannel];
+            fCurrentAverageLevels[nChannel] = fRmsLevels[nChannel];
+
+            // update registered number of overflows
+            nNumberOfOverflows[nChannel] += nOverflows[nChannel];
+        }
+        else
+        {
+            // padding channels keep their minimum readings
+            fCurrentPeakLevels[nChannel] = 0.0f;
+            fCurrentAverageLevels[nChannel] = 0.0f;
+        }
+    }
+
+    // convert current levels from linear scale to decibels (all
+    // channels at once)
+    levels2decibels(fCurrentPeakLevels, fCurrentPeakLevels, nChannels);
+    levels2decibels(fCurrentAverageLevels, fCurrentAverageLevels, nChannels);
+
+    // apply peak-to-average correction to RMS levels
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fCurrentAverageLevels[nChannel] += fPeakToAverageCorrection;
+    }
+
+#if METER_BALLISTICS_SSE2
+    updateAllChannelsSSE2<nFixedChannels>(fTimePassed);
+#else
+    updateAllChannelsScalar<nFixedChannels>(fTimePassed);
+#endif
+}
+
+
+template <int nFixedChannels>
+void MeterBallistics::updateAllChannelsScalar(float fTimePassed)
+/*  Apply meter ballistics to the levels in "fCurrentPeakLevels" and
+    "fCurrentAverageLevels" (in decibels) of all channels.
+
+    fTimePassed (float): time that has passed since last update (in
+    fractional seconds)
+
+    return value: none
+*/
+{
+    const int nChannels = (nFixedChannels > 0) ? nFixedChannels : nPaddedChannels;
+
+    for (int nChannel = 0; nChannel < nChannels; nChannel++)
+    {
+        float fPeak = fCurrentPeakLevels[nChannel];
+
+        if (fPeak > fMaximumPeakLevels[nChannel])
+        {
+            fMaximumPeakLevels[nChannel] = fPeak;
+        }
+
+        fPeakMeterLevels[nChannel] = PeakMeterBallistics(fPeak, fPeakMeterLevels[nChannel]);
+        fPeakMeterPeakLevels[nChannel] = PeakMeterPeakBallistics(fTimePassed, &fPeakMeterPeakLastChanged[nChannel], fPeak, fPeakMeterPeakLevels[nChannel]);
+
+        PeakMeterSignalBallistics(nChannel, fPeak);
+
+        AverageMeterBallistics(nChannel, fCurrentAverageLevels[nChannel]);
+        fAverageMeterPeakLevels[nChannel] = AverageMeterPeakBallistics(fTimePassed, &fAverageMeterPeakLastChanged[nChannel], fAverageMeterLevels[nChannel], fAverageMeterPeakLevels[nChannel]);
+    }
+}
+
+
+#if METER_BALLISTICS_SSE2
+
+// select "a" where mask is set and "b" otherwise
+static inline __m128 selectSSE2(__m128 vMask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(vMask, a), _mm_andnot_ps(vMask, b));
+}
+
+
+// branchless version of "PeakMeterPeakBallistics" for four channels
+static inline __m128 peakMarkBallisticsSSE2(__m128 vTimePassed, __m128 vReleaseCoef, float *fLastChanged, __m128 vPeakCurrent, __m128 vPeakOld)
+{
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vHoldTime = _mm_set1_ps(10.0f);
+
+    // prevent meter overshoot on overflows by limiting peak levels to
+    // 0.0 dBFS
+    vPeakCurrent = _mm_min_ps(vPeakCurrent, vZero);
+
+    __m128 vLastChanged = _mm_load_ps(fLastChanged);
+    __m128 vIsRising = _mm_cmpge_ps(vPeakCurrent, vPeakOld);
+    __m128 vIsFallingPeaks = _mm_cmpge_ps(vLastChanged, vZero);
+
+    // "falling peaks" mode: reset hold time on rise, otherwise update
+    // it; "infinite peak hold" mode: keep negative value
+    __m128 vUpdated = selectSSE2(vIsRising, vZero, _mm_add_ps(vLastChanged, vTimePassed));
+    vLastChanged = selectSSE2(vIsFallingPeaks, vUpdated, vLastChanged);
+    _mm_store_ps(fLastChanged, vLastChanged);
+
+    // retain old peak mark during hold time, then let it fall
+    __m128 vIsHeld = _mm_cmplt_ps(vLastChanged, vHoldTime);
+    __m128 vFalling = selectSSE2(vIsHeld, vPeakOld, _mm_sub_ps(vPeakOld, vReleaseCoef));
+
+    return selectSSE2(vIsRising, vPeakCurrent, vFalling);
+}
+
+
+// logarithmic ballistics: coef * (readout - level) + level
+static inline __m128 logBallisticsSSE2(__m128 vCoef, __m128 vLevel, __m128 vReadout)
+{
+    return _mm_add_ps(_mm_mul_ps(vCoef, _mm_sub_ps(vReadout, vLevel)), vLevel);
+}
+
+
+template <int nFixedChannels>
+void MeterBallistics::updateAllChannelsSSE2(float fTimePassed)
+/*  Apply meter ballistics to the levels in "fCurrentPeakLevels" and
+    "fCurrentAverageLevels" (in decibels) of four channels at a time.
+    Rise and fall are selected with masks instead of branches.
+
+    fTimePassed (float): time that has passed since last update (in
+    fractional seconds)
+
+    return value: none
+*/
+{
+    const __m128 vTimePassed = _mm_set1_ps(fTimePassed);
+    const __m128 vPeakMeterReleaseCoef = _mm_set1_ps(fPeakMeterReleaseCoef);
+    const __m128 vAverageMeterReleaseCoef = _mm_set1_ps(fAverageMeterReleaseCoef);
+    const __m128 vTransientModeCoef = _mm_set1_ps(fTransientModeCoef);
+    const __m128 vAveragingModeCoef = _mm_set1_ps(fAveragingModeCoef);
+    const __m128 vPeakMeterSignalCoef = _mm_set1_ps(fPeakMeterSignalCoef);
+
+    // one iteration for the stereo build, two for the multi build
+    const int nChannels = (nFixedChannels > 0) ? nFixedChannels : nPaddedChannels;
+
+    for (int nChannel = 0; nChannel < nChannels; nChannel += 4)
+    {
+        __m128 vPeak = _mm_load_ps(fCurrentPeakLevels + nChannel);
+        __m128 vAverage = _mm_load_ps(fCurrentAverageLevels + nChannel);
+
+        // overall maximum peak level
+        __m128 vMaximum = _mm_load_ps(fMaximumPeakLevels + nChannel);
+        _mm_store_ps(fMaximumPeakLevels + nChannel, _mm_max_ps(vPeak, vMaximum));
+
+        // peak meter: immediate rise, linear fall
+        __m128 vPeakMeter = _mm_load_ps(fPeakMeterLevels + nChannel);
+        __m128 vIsRising = _mm_cmpge_ps(vPeak, vPeakMeter);
+        vPeakMeter = selectSSE2(vIsRising, vPeak, _mm_sub_ps(vPeakMeter, vPeakMeterReleaseCoef));
+        _mm_store_ps(fPeakMeterLevels + nChannel, vPeakMeter);
+
+        // peak meter peak mark
+        __m128 vPeakMark = _mm_load_ps(fPeakMeterPeakLevels + nChannel);
+        vPeakMark = peakMarkBallisticsSSE2(vTimePassed, vPeakMeterReleaseCoef, fPeakMeterPeakLastChanged + nChannel, vPeak, vPeakMark);
+        _mm_store_ps(fPeakMeterPeakLevels + nChannel, vPeakMark);
+
+        // peak meter signal: immediate rise, logarithmic fall
+        __m128 vSignal = _mm_load_ps(fPeakMeterSignals + nChannel);
+        vIsRising = _mm_cmpge_ps(vPeak, vSignal);
+        vSignal = selectSSE2(vIsRising, vPeak, logBallisticsSSE2(vPeakMeterSignalCoef, vPeak, vSignal));
+        _mm_store_ps(fPeakMeterSignals + nChannel, vSignal);
+
+        // average meter
+        __m128 vAverageMeter = _mm_load_ps(fAverageMeterLevels + nChannel);
+
+        if (bTransientMode)
+        {
+            // logarithmic rise, linear fall (but not below current
+            // level)
+            __m128 vIsFalling = _mm_cmplt_ps(vAverage, vAverageMeter);
+            __m128 vFalling = _mm_max_ps(_mm_sub_ps(vAverageMeter, vAverageMeterReleaseCoef), vAverage);
+            vAverageMeter = selectSSE2(vIsFalling, vFalling, logBallisticsSSE2(vTransientModeCoef, vAverage, vAverageMeter));
+        }
+        else
+        {
+            vAverageMeter = logBallisticsSSE2(vAveragingModeCoef, vAverage, vAverageMeter);
+        }
+
+        _mm_store_ps(fAverageMeterLevels + nChannel, vAverageMeter);
+
+        // average meter peak mark
+        __m128 vAverageMark = _mm_load_ps(fAverageMeterPeakLevels + nChannel);
+        vAverageMark = peakMarkBallisticsSSE2(vTimePassed, vPeakMeterReleaseCoef, fAverageMeterPeakLastChanged + nChannel, vAverageMeter, vAverageMark);
+        _mm_store_ps(fAverageMeterPeakLevels + nChannel, vAverageMark);
+    }
+}
+
+#endif  // METER_BALLISTICS_SSE2
+
+
+void MeterBallistics::updateCoefficients(float fTimePassed)
+/*  Calculate ballistics coefficients.  As the time passed between
+    updates hardly ever changes, this only does real work (and calls
+    "powf") when it does.
+
+    fTimePassed (float): time that has passed since last update (in
+    fractional seconds)
+
+    return value: none
+*/
+{
+    if (fTimePassed == fCoefficientsTimePassed)
+    {
+        return;
+    }
+
+    fCoefficientsTimePassed = fTimePassed;
+
+    // peak meter and peak marks fall 26 dB in 3 seconds (linear)
+    fPeakMeterReleaseCoef = 26.0f * fTimePassed / 3.0f;
+
+    // average meter falls 6 dB per second in "transient mode"
+    // (linear)
+    fAverageMeterReleaseCoef = 6.0f * fTimePassed;
+
+    // Thanks to Bram de Jong for the code snippet!
+    // (http://www.musicdsp.org/showone.php?id=136)
+    //
+    // logarithmic rise and fall: 99% of final reading in 10 ms
+    // ("transient mode"), 300 ms ("averaging mode") and 1200 ms (peak
+    // meter signal)
+    fTransientModeCoef = powf(0.01f, fTimePassed / 0.010f);
+    fAveragingModeCoef = powf(0.01f, fTimePassed / 0.300f);
+    fPeakMeterSignalCoef = powf(0.01f, fTimePassed / 1.200f);
+}
+
+
+void MeterBallistics::fillSnapshot(MeterSnapshot *pSnapshot)
+/*  Copy current meter readings (including crest factor) to a snapshot.
+
+    pSnapshot (pointer to MeterSnapshot): snapshot to be filled
+
+    return value: none
+*/
+{
+    jassert(nNumberOfChannels <= JucePlugin_MaxNumInputChannels);
+
+    int nChannels = jmin(nNumberOfChannels, (int) JucePlugin_MaxNumInputChannels);
+    float fCrestFactor = (float) nCrestFactor;
+
+    pSnapshot->nNumberOfChannels = nChannels;
+
+    for (int nChannel = 0; nChannel < nChannels; nChannel++)
+    {
+        pSnapshot->fPeakMeterLevels[nChannel] = fPeakMeterLevels[nChannel] + fCrestFactor;
+        pSnapshot->fPeakMeterPeakLevels[nChannel] = fPeakMeterPeakLevels[nChannel] + fCrestFactor;
+
+        pSnapshot->fAverageMeterLevels[nChannel] = fAverageMeterLevels[nChannel] + fCrestFactor;
+        pSnapshot->fAverageMeterPeakLevels[nChannel] = fAverageMeterPeakLevels[nChannel] + fCrestFactor;
+
+        pSnapshot->fPeakMeterSignals[nChannel] = fPeakMeterSignals[nChannel] + fCrestFactor;
+        pSnapshot->fMaximumPeakLevels[nChannel] = fMaximumPeakLevels[nChannel] + fCrestFactor;
+        pSnapshot->nNumberOfOverflows[nChannel] = nNumberOfOverflows[nChannel];
+    }
+}
+
+
 float MeterBallistics::level2decibel(float fLevel)
 /*  Convert level from linear scale to decibels (dB).
 
@@ -448,6 +804,130 @@ float MeterBallistics::level2decibel(float fLevel)
 }
 
 
+void MeterBallistics::levels2decibels(const float *fLevels, float *fDecibels, int nNumberOfValues)
+/*  Convert an array of levels from linear scale to decibels (dB).
+    Source and destination may be identical.
+
+    Unless METER_BALLISTICS_FAST_LOG is set to 0, four levels at a
+    time are converted using a fast approximation of the logarithm:
+    the level is split into exponent and mantissa, and the logarithm
+    of the mantissa (normalised to [sqrt(0.5), sqrt(2)]) is calculated
+    from the first four terms of the series of atanh.  At the edges of
+    this interval, the first omitted term amounts to 2.5e-7 dB and all
+    omitted terms to less than 2.6e-7 dB.  The total error is dominated
+    by rounding: for every level between "fMeterMinimumDecibel" and
+    +20 dB, it stays below 0.00001 dB (maximum 8.2e-6 dB, compared to
+    9.4e-6 dB for "log10f").  Levels within 0.00004 dB of a segment
+    threshold (a multiple of 0.1 dB) are converted with "log10f", so
+    that the displayed segments never differ from "level2decibel".
+    The regression suite checks both.
+
+    fLevels (float array): audio levels
+
+    fDecibels (float array): returns levels in decibels (dB) when
+    above "fMeterMinimumDecibel", otherwise "fMeterMinimumDecibel"
+
+    nNumberOfValues (integer): number of levels to convert
+
+    return value: none
+*/
+{
+    int nValue = 0;
+
+#if METER_BALLISTICS_FAST_LOG && METER_BALLISTICS_SSE2
+    // 20 * log10(2)
+    const __m128 vDecibelsPerOctave = _mm_set1_ps(6.0205999f);
+
+    // 2 / ln(2) * (1, 1/3, 1/5, 1/7)
+    const __m128 vCoefficient1 = _mm_set1_ps(2.8853901f);
+    const __m128 vCoefficient3 = _mm_set1_ps(0.9617967f);
+    const __m128 vCoefficient5 = _mm_set1_ps(0.5770780f);
+    const __m128 vCoefficient7 = _mm_set1_ps(0.4121986f);
+
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    const __m128 vSquareRootOfTwo = _mm_set1_ps(1.4142135f);
+    const __m128 vMinimumLevel = _mm_set1_ps(1e-30f);
+    const __m128 vMinimumDecibel = _mm_set1_ps(fMeterMinimumDecibel);
+
+    // segment thresholds lie on a grid of 0.1 dB; levels closer than
+    // 0.00004 dB (twice the combined error of both conversions) are
+    // converted with "log10f"
+    const __m128 vTenthsPerDecibel = _mm_set1_ps(10.0f);
+    const __m128 vThresholdDistance = _mm_set1_ps(0.0004f);
+    const __m128 vSignMask = _mm_set1_ps(-0.0f);
+
+    const __m128i vMantissaMask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i vExponentOfOne = _mm_set1_epi32(0x3F800000);
+    const __m128i vExponentBias = _mm_set1_epi32(127);
+
+    for (; nValue + 4 <= nNumberOfValues; nValue += 4)
+    {
+        // keep levels positive and normal (NaNs are turned into the
+        // minimum level, as "_mm_max_ps" returns the second operand)
+        __m128 vInput = _mm_loadu_ps(fLevels + nValue);
+        __m128 vLevel = _mm_max_ps(vInput, vMinimumLevel);
+
+        // split level into exponent and mantissa in [1, 2)
+        __m128i vBits = _mm_castps_si128(vLevel);
+        __m128i vExponent = _mm_sub_epi32(_mm_srli_epi32(vBits, 23), vExponentBias);
+        __m128 vMantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(vBits, vMantissaMask), vExponentOfOne));
+
+        // move mantissa to [sqrt(0.5), sqrt(2)] to speed up
+        // convergence (comparison yields -1 for every change)
+        __m128 vIsLarge = _mm_cmpgt_ps(vMantissa, vSquareRootOfTwo);
+        vMantissa = selectSSE2(vIsLarge, _mm_mul_ps(vMantissa, vHalf), vMantissa);
+        vExponent = _mm_sub_epi32(vExponent, _mm_castps_si128(vIsLarge));
+
+        // log2(m) = 2 / ln(2) * atanh(t), where t = (m - 1) / (m + 1)
+        __m128 vT = _mm_div_ps(_mm_sub_ps(vMantissa, vOne), _mm_add_ps(vMantissa, vOne));
+        __m128 vT2 = _mm_mul_ps(vT, vT);
+
+        __m128 vPolynomial = _mm_add_ps(vCoefficient5, _mm_mul_ps(vT2, vCoefficient7));
+        vPolynomial = _mm_add_ps(vCoefficient3, _mm_mul_ps(vT2, vPolynomial));
+        vPolynomial = _mm_add_ps(vCoefficient1, _mm_mul_ps(vT2, vPolynomial));
+
+        __m128 vLog2 = _mm_add_ps(_mm_cvtepi32_ps(vExponent), _mm_mul_ps(vT, vPolynomial));
+
+        // do not return levels below "fMeterMinimumDecibel"
+        __m128 vDecibels = _mm_max_ps(_mm_mul_ps(vLog2, vDecibelsPerOctave), vMinimumDecibel);
+
+        // find levels close to a segment threshold
+        __m128 vTenths = _mm_mul_ps(vDecibels, vTenthsPerDecibel);
+        __m128 vDistance = _mm_sub_ps(vTenths, _mm_cvtepi32_ps(_mm_cvtps_epi32(vTenths)));
+        int nCloseToThreshold = _mm_movemask_ps(_mm_cmplt_ps(_mm_andnot_ps(vSignMask, vDistance), vThresholdDistance));
+
+        _mm_storeu_ps(fDecibels + nValue, vDecibels);
+
+        // rare (about 0.08 % of all levels), so do not bother about
+        // speed here
+        if (nCloseToThreshold != 0)
+        {
+            // source and destination may be identical, so use the
+            // levels that have been loaded
+            float fInput[4];
+            _mm_storeu_ps(fInput, vInput);
+
+            for (int nLane = 0; nLane < 4; nLane++)
+            {
+                if (nCloseToThreshold & (1 << nLane))
+                {
+                    fDecibels[nValue + nLane] = level2decibel(fInput[nLane]);
+                }
+            }
+        }
+    }
+
+#endif
+
+    // process remaining levels
+    for (; nValue < nNumberOfValues; nValue++)
+    {
+        fDecibels[nValue] = level2decibel(fLevels[nValue]);
+    }
+}
+
+
 float MeterBallistics::decibel2level(float fDecibels)
 /*  Convert level from decibels (dB) to linear scale.
 
@@ -521,12 +1001,9 @@ float MeterBallistics::getMeterMinimumDecibel()
 }
 
 
-float MeterBallistics::PeakMeterBallistics(float fTimePassed, float fPeakLevelCurrent, float fPeakLevelOld)
+float MeterBallistics::PeakMeterBallistics(float fPeakLevelCurrent, float fPeakLevelOld)
 /*  Calculate ballistics for peak meter levels.
 
-    fTimePassed (float): time that has passed since last update (in
-    fractional seconds)
-
     fPeakLevelCurrent (float): current peak meter level in decibel
 
     fPeakLevelOld (float): old peak meter reading in decibel
@@ -545,10 +1022,7 @@ float MeterBallistics::PeakMeterBallistics(float fTimePassed, float fPeakLevelCu
     else
     {
         // fall time: 26 dB in 3 seconds (linear)
-        float fReleaseCoef = 26.0f * fTimePassed / 3.0f;
-
-        // apply fall time and return new peak meter reading
-        return fPeakLevelOld - fReleaseCoef;
+        return fPeakLevelOld - fPeakMeterReleaseCoef;
     }
 }
 
@@ -617,10 +1091,7 @@ float MeterBallistics::PeakMeterPeakBallistics(float fTimePassed, float *fLastCh
         else
         {
             // fall time: 26 dB in 3 seconds (linear)
-            float fReleaseCoef = 26.0f * fTimePassed / 3.0f;
-
-            // apply fall time
-            fOutput = fPeakOld - fReleaseCoef;
+            fOutput = fPeakOld - fPeakMeterReleaseCoef;
         }
     }
 
@@ -629,11 +1100,10 @@ float MeterBallistics::PeakMeterPeakBallistics(float fTimePassed, float *fLastCh
 }
 
 
-void MeterBallistics::AverageMeterBallistics(int nChannel, float fTimePassed, float fAverageLevelCurrent)
+void MeterBallistics::AverageMeterBallistics(int nChannel, float fAverageLevelCurrent)
 /*  Calculate ballistics for average meter levels and update readout.
 
-    fTimePassed (float): time that has passed since last update (in
-    fractional seconds)
+    nChannel (integer): audio input channel to update
 
     fAverageLevelCurrent (float): current average meter level in
     decibel
@@ -650,10 +1120,7 @@ void MeterBallistics::AverageMeterBallistics(int nChannel, float fTimePassed, fl
         if (fAverageLevelCurrent < fAverageMeterLevels[nChannel])
         {
             // fall time: 6 dB per second (linear)
-            float fReleaseCoef = 6.0f * fTimePassed;
-
-            // apply fall time
-            fAverageMeterLevels[nChannel] -= fReleaseCoef;
+            fAverageMeterLevels[nChannel] -= fAverageMeterReleaseCoef;
 
             // make sure that meter doesn't fall below current level
             if (fAverageLevelCurrent > fAverageMeterLevels[nChannel])
@@ -665,14 +1132,14 @@ void MeterBallistics::AverageMeterBallistics(int nChannel, float fTimePassed, fl
         else
         {
             // meter reaches 99% of the final reading in 10 ms
-            LogMeterBallistics(0.010f, fTimePassed, fAverageLevelCurrent, fAverageMeterLevels[nChannel]);
+            LogMeterBallistics(fTransientModeCoef, fAverageLevelCurrent, fAverageMeterLevels[nChannel]);
         }
     }
     // in "classic mode", the meter reaches 99% of the final reading
     // in 300 ms (logarithmic)
     else
     {
-        LogMeterBallistics(0.300f, fTimePassed, fAverageLevelCurrent, fAverageMeterLevels[nChannel]);
+        LogMeterBallistics(fAveragingModeCoef, fAverageLevelCurrent, fAverageMeterLevels[nChannel]);
     }
 }
 
@@ -699,11 +1166,10 @@ float MeterBallistics::AverageMeterPeakBallistics(float fTimePassed, float *fLas
 }
 
 
-void MeterBallistics::PeakMeterSignalBallistics(int nChannel, float fTimePassed, float fPeakMeterSignalCurrent)
+void MeterBallistics::PeakMeterSignalBallistics(int nChannel, float fPeakMeterSignalCurrent)
 /*  Calculate ballistics for peak meter signal levels and update readout.
 
-    fTimePassed (float): time that has passed since last update (in
-    fractional seconds)
+    nChannel (integer): audio input channel to update
 
     fPeakMeterSignalCurrent (float): current peak meter signal level in
     decibel
@@ -722,19 +1188,16 @@ void MeterBallistics::PeakMeterSignalBallistics(int nChannel, float fTimePassed,
     else
     {
         // meter reaches 99% of the final reading in 1200 ms
-        LogMeterBallistics(1.200f, fTimePassed, fPeakMeterSignalCurrent, fPeakMeterSignals[nChannel]);
+        LogMeterBallistics(fPeakMeterSignalCoef, fPeakMeterSignalCurrent, fPeakMeterSignals[nChannel]);
     }
 }
 
 
-void MeterBallistics::LogMeterBallistics(float fMeterInertia, float fTimePassed, float fLevel, float &fReadout)
+void MeterBallistics::LogMeterBallistics(float fAttackReleaseCoef, float fLevel, float &fReadout)
 /*  Calculate logarithmic meter ballistics.
 
-    fMeterInertia (float): time needed to reach 99% of the final
-    readout (in fractional seconds)
-
-    fTimePassed (float): time that has passed since last update (in
-    fractional seconds)
+    fAttackReleaseCoef (float): coefficient for the time passed since
+    last update (see "updateCoefficients")
 
     fLevel (float): new meter level
 
@@ -748,11 +1211,8 @@ void MeterBallistics::LogMeterBallistics(float fMeterInertia, float fTimePassed,
     // meter readout are not equal
     if (fLevel != fReadout)
     {
-        // Thanks to Bram de Jong for the code snippet!
-        // (http://www.musicdsp.org/showone.php?id=136)
-        //
-        // rise and fall: 99% of final reading in "fMeterInertia" seconds
-        float fAttackReleaseCoef = powf(0.01f, fTimePassed / fMeterInertia);
+        // rise and fall: 99% of final reading in the meter's
+        // inertia time (see "updateCoefficients")
         fReadout = fAttackReleaseCoef * (fReadout - fLevel) + fLevel;
     }
 }
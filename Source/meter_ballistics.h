@@ -27,7 +27,26 @@
 #define __METER_BALLISTICS_H__
 
 #include "JuceHeader.h"
-#include "plugin_processor.h"
+#include "meter_snapshot.h"
+
+// state arrays are aligned to cache lines and padded to a multiple of
+// this many channels, so that they can be processed with SIMD
+// instructions without special-casing the last channels
+#define METER_BALLISTICS_ALIGNMENT 64
+#define METER_BALLISTICS_CHANNEL_PADDING 4
+
+// padded channel count of the build (4 for stereo, 8 for multi); meters
+// with this channel count get kernels with fully unrolled channel
+// loops
+#define METER_BALLISTICS_BUILD_CHANNELS (((JucePlugin_MaxNumInputChannels + METER_BALLISTICS_CHANNEL_PADDING - 1) / METER_BALLISTICS_CHANNEL_PADDING) * METER_BALLISTICS_CHANNEL_PADDING)
+
+// convert levels to decibels with a polynomial approximation of the
+// logarithm (series truncated after 2.6e-7 dB; including rounding, the
+// error stays below 0.00001 dB above the meter minimum); set to 0 to
+// use "log10f"
+#ifndef METER_BALLISTICS_FAST_LOG
+#define METER_BALLISTICS_FAST_LOG 1
+#endif
 
 
 //==============================================================================
@@ -48,6 +67,9 @@ public:
     int getCrestFactor();
     void setCrestFactor(int CrestFactor);
 
+    bool getTransientMode();
+    void setTransientMode(bool transient_mode);
+
     float getPeakMeterLevel(int nChannel);
     float getPeakMeterPeakLevel(int nChannel);
 
@@ -59,8 +81,11 @@ public:
     int getNumberOfOverflows(int nChannel);
 
     void updateChannel(int nChannel, float fTimePassed, float fPeak, float fRms, int nOverflows);
+    void updateAllChannels(float fTimePassed, const float *fPeaks, const float *fRmsLevels, const int *nOverflows);
+    void fillSnapshot(MeterSnapshot *pSnapshot);
 
     static float level2decibel(float fLevel);
+    static void levels2decibels(const float *fLevels, float *fDecibels, int nNumberOfValues);
     static float decibel2level(float fDecibels);
     static double level2decibel_double(double dLevel);
     static double decibel2level_double(double dDecibels);
@@ -69,12 +94,16 @@ private:
     JUCE_LEAK_DETECTOR(MeterBallistics);
 
     int nNumberOfChannels;
+    int nPaddedChannels;
     int nCrestFactor;
     bool bTransientMode;
 
     static float fMeterMinimumDecibel;
     static float fPeakToAverageCorrection;
 
+    // all channel state lives in this block (structure of arrays)
+    HeapBlock<char> pStateMemory;
+
     float *fPeakMeterLevels;
     float *fPeakMeterPeakLevels;
 
@@ -88,15 +117,40 @@ private:
     float *fPeakMeterPeakLastChanged;
     float *fAverageMeterPeakLastChanged;
 
-    float PeakMeterBallistics(float fTimePassed, float fPeakLevelCurrent, float fPeakLevelOld);
+    // input levels in decibel (scratch space for "updateAllChannels")
+    float *fCurrentPeakLevels;
+    float *fCurrentAverageLevels;
+
+    // coefficients only change with the time passed between updates
+    float fCoefficientsTimePassed;
+    float fPeakMeterReleaseCoef;
+    float fAverageMeterReleaseCoef;
+    float fTransientModeCoef;
+    float fAveragingModeCoef;
+    float fPeakMeterSignalCoef;
+
+    void updateCoefficients(float fTimePassed);
+
+    // "nFixedChannels" is the padded channel count known at compile
+    // time (or 0 to use the channel count of the meter)
+    template <int nFixedChannels>
+    void updateAllChannelsFixed(float fTimePassed, const float *fPeaks, const float *fRmsLevels, const int *nOverflows);
+
+    template <int nFixedChannels>
+    void updateAllChannelsScalar(float fTimePassed);
+
+    template <int nFixedChannels>
+    void updateAllChannelsSSE2(float fTimePassed);
+
+    float PeakMeterBallistics(float fPeakLevelCurrent, float fPeakLevelOld);
     float PeakMeterPeakBallistics(float fTimePassed, float *fLastChanged, float fPeakLevelCurrent, float fPeakLevelOld);
 
-    void AverageMeterBallistics(int nChannel, float fTimePassed, float fAverageLevelCurrent);
+    void AverageMeterBallistics(int nChannel, float fAverageLevelCurrent);
     float AverageMeterPeakBallistics(float fTimePassed, float *fLastChanged, float fAverageLevelCurrent, float fAverageLevelOld);
 
-    void PeakMeterSignalBallistics(int nChannel, float fTimePassed, float fPeakMeterSignalCurrent);
+    void PeakMeterSignalBallistics(int nChannel, float fPeakMeterSignalCurrent);
 
-    void LogMeterBallistics(float fMeterInertia, float fTimePassed, float fLevel, float &fReadout);
+    void LogMeterBallistics(float fAttackReleaseCoef, float fLevel, float &fReadout);
 };
 
 
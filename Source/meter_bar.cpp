@@ -0,0 +1,417 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_bar.h"
+
+
+MeterBar::MeterBar(const String &componentName, int pos_x, int pos_y, int width, int number_of_segments, int segment_height, bool display_peaks)
+{
+    setName(componentName);
+
+    // this component does not have any transparent areas (increases
+    // performance on redrawing)
+    setOpaque(true);
+
+    nNumberOfSegments = number_of_segments;
+    nSegmentHeight = segment_height;
+    displayPeaks = display_peaks;
+
+    nPosX = pos_x;
+    nPosY = pos_y;
+    nWidth = width;
+    nHeight = nNumberOfSegments * nSegmentHeight + 1;
+
+    fLevel = -9999.9f;
+    fLevelPeak = -9999.9f;
+
+    // all segments are dark
+    nLevelSegment = nNumberOfSegments;
+    nPeakSegment = -1;
+
+    fLowerThresholds = new float[nNumberOfSegments];
+    fUpperThresholds = new float[nNumberOfSegments];
+    fThresholdRanges = new float[nNumberOfSegments];
+    fHues = new float[nNumberOfSegments];
+    fBrightnesses = new float[nNumberOfSegments];
+    bDiscreteLevels = new bool[nNumberOfSegments];
+    bPeakMarkers = new bool[nNumberOfSegments];
+
+    // segments are defined by derived classes; until then, they stay
+    // dark (thresholds must fall from top to bottom)
+    for (int nSegment = 0; nSegment < nNumberOfSegments; nSegment++)
+    {
+        setSegment(nSegment, -nSegment * 1.0f, 1.0f, false, 3);
+    }
+}
+
+
+MeterBar::~MeterBar()
+{
+    delete [] fLowerThresholds;
+    fLowerThresholds = nullptr;
+
+    delete [] fUpperThresholds;
+    fUpperThresholds = nullptr;
+
+    delete [] fThresholdRanges;
+    fThresholdRanges = nullptr;
+
+    delete [] fHues;
+    fHues = nullptr;
+
+    delete [] fBrightnesses;
+    fBrightnesses = nullptr;
+
+    delete [] bDiscreteLevels;
+    bDiscreteLevels = nullptr;
+
+    delete [] bPeakMarkers;
+    bPeakMarkers = nullptr;
+}
+
+
+int MeterBar::getNumberOfSegments()
+{
+    return nNumberOfSegments;
+}
+
+
+void MeterBar::resetLevels()
+/*  Darken all segments, e.g. before they are redefined.  The bar will
+    be fully updated on the next call of setLevels().
+
+    return value: none
+*/
+{
+    fLevel = -9999.9f;
+    fLevelPeak = -9999.9f;
+
+    nLevelSegment = nNumberOfSegments;
+    nPeakSegment = -1;
+
+    for (int nSegment = 0; nSegment < nNumberOfSegments; nSegment++)
+    {
+        updateSegment(nSegment);
+    }
+
+    repaint();
+}
+
+
+void MeterBar::setSegment(int nSegment, float fThreshold, float fRange, bool bDiscrete, int nColor)
+/*  Define a meter segment.  Segments are numbered from top to bottom.
+
+    nSegment (integer): selected segment
+
+    fThreshold (float): lower threshold; the segment will be dark
+    below this level
+
+    fRange (float): level range above lower threshold; this affects
+    the brightness
+
+    bDiscrete (Boolean): light segment fully when the level lies
+    within its range (and keep it dark above)
+
+    nColor (integer): colour number (0: red, 1: yellow, 2: green,
+    3: blue)
+
+    return value: none
+*/
+{
+    jassert(nSegment >= 0);
+    jassert(nSegment < nNumberOfSegments);
+
+    fLowerThresholds[nSegment] = fThreshold;
+    fThresholdRanges[nSegment] = fRange;
+    fUpperThresholds[nSegment] = fThreshold + fRange;
+    bDiscreteLevels[nSegment] = bDiscrete;
+
+    // segments must be defined from top to bottom, and their
+    // thresholds must not overlap
+    jassert((nSegment == 0) || (fUpperThresholds[nSegment] <= fLowerThresholds[nSegment - 1]));
+
+    if (nColor == 0)
+    {
+        // meter segment is red
+        fHues[nSegment] = 0.00f;
+    }
+    else if (nColor == 1)
+    {
+        // meter segment is yellow
+        fHues[nSegment] = 0.18f;
+    }
+    else if (nColor == 2)
+    {
+        // meter segment is green
+        fHues[nSegment] = 0.30f;
+    }
+    else
+    {
+        // meter segment is blue
+        fHues[nSegment] = 0.58f;
+    }
+
+    fBrightnesses[nSegment] = 0.0f;
+    bPeakMarkers[nSegment] = false;
+
+    updateSegment(nSegment);
+}
+
+
+void MeterBar::visibilityChanged()
+{
+    setBounds(nPosX, nPosY, nWidth, nHeight);
+}
+
+
+void MeterBar::resized()
+{
+}
+
+
+Rectangle<int> MeterBar::getSegmentBounds(int nSegment)
+{
+    // neighbouring segments share one row of pixels
+    return Rectangle<int>(0, nSegment * nSegmentHeight, nWidth, nSegmentHeight + 1);
+}
+
+
+void MeterBar::paint(Graphics &g)
+{
+    g.fillAll(Colours::black);
+
+    // later segments are drawn on top of earlier ones (just like
+    // sibling components)
+    for (int nSegment = 0; nSegment < nNumberOfSegments; nSegment++)
+    {
+        Rectangle<int> rectSegment = getSegmentBounds(nSegment);
+
+        if (!g.clipRegionIntersects(rectSegment))
+        {
+            continue;
+        }
+
+        MeterSpriteCache::SegmentBorder border;
+
+        // if peak marker is lit, draw a rectangle around meter
+        // segment (width: 1 pixel)
+        if (bPeakMarkers[nSegment])
+        {
+            border = MeterSpriteCache::borderPeakMarker;
+        }
+        else if (!displayPeaks)
+        {
+            border = MeterSpriteCache::borderBlack;
+        }
+        else
+        {
+            border = MeterSpriteCache::borderNone;
+        }
+
+        // unlit borders of the sprite are transparent, so overlapping
+        // segments look exactly as if they were painted directly
+        Image imageSegment = spriteCache->getSegment(rectSegment.getWidth(), rectSegment.getHeight(), fHues[nSegment], fBrightnesses[nSegment], border);
+        g.drawImageAt(imageSegment, rectSegment.getX(), rectSegment.getY());
+    }
+}
+
+
+void MeterBar::setLevels(float level, float levelPeak)
+{
+    if ((level == fLevel) && (levelPeak == fLevelPeak))
+    {
+        return;
+    }
+
+    fLevel = level;
+    fLevelPeak = levelPeak;
+
+    int nLevelSegmentOld = nLevelSegment;
+    int nPeakSegmentOld = nPeakSegment;
+
+    nLevelSegment = findSegment(fLevel);
+    nPeakSegment = findSegment(fLevelPeak);
+
+    // peak marker is only shown when the peak lies within the
+    // thresholds of a segment
+    if ((nPeakSegment >= nNumberOfSegments) || (fLevelPeak > fUpperThresholds[nPeakSegment]))
+    {
+        nPeakSegment = -1;
+    }
+
+    // segments above both the old and the new level segment stay
+    // dark, and segments below stay lit, so only the segments in
+    // between (and the peak markers) may have changed
+    int nFirstSegment = jmin(nLevelSegmentOld, nLevelSegment);
+    int nLastSegment = jmin(jmax(nLevelSegmentOld, nLevelSegment), nNumberOfSegments - 1);
+
+    // merge changed segments into a single dirty rectangle
+    Rectangle<int> rectDirty;
+
+    for (int nSegment = nFirstSegment; nSegment <= nLastSegment; nSegment++)
+    {
+        if (updateSegment(nSegment))
+        {
+            rectDirty = rectDirty.getUnion(getSegmentBounds(nSegment));
+        }
+    }
+
+    int nPeakSegments[2] = {nPeakSegmentOld, nPeakSegment};
+
+    for (int nIndex = 0; nIndex < 2; nIndex++)
+    {
+        int nSegment = nPeakSegments[nIndex];
+
+        // skip missing peak markers and segments that have already
+        // been updated
+        if ((nSegment < 0) || ((nSegment >= nFirstSegment) && (nSegment <= nLastSegment)))
+        {
+            continue;
+        }
+
+        if (updateSegment(nSegment))
+        {
+            rectDirty = rectDirty.getUnion(getSegmentBounds(nSegment));
+        }
+    }
+
+    if (!rectDirty.isEmpty())
+    {
+        repaint(rectDirty);
+    }
+}
+
+
+int MeterBar::findSegment(float fLevelToFind)
+/*  Find the first segment (from top) whose lower threshold lies below
+    the given level.
+
+    fLevelToFind (float): level
+
+    return value (integer): segment number (or nNumberOfSegments if
+    the level lies on or below all lower thresholds)
+*/
+{
+    // binary search; lower thresholds fall from top to bottom
+    int nFirst = 0;
+    int nLast = nNumberOfSegments;
+
+    while (nFirst < nLast)
+    {
+        int nMiddle = (nFirst + nLast) / 2;
+
+        if (fLowerThresholds[nMiddle] < fLevelToFind)
+        {
+            nLast = nMiddle;
+        }
+        else
+        {
+            nFirst = nMiddle + 1;
+        }
+    }
+
+    return nFirst;
+}
+
+
+bool MeterBar::updateSegment(int nSegment)
+/*  Update brightness and peak marker of a segment from the current
+    levels.
+
+    nSegment (integer): selected segment
+
+    return value (Boolean): true if the segment has to be re-painted
+*/
+{
+    // store old brightness and peak marker values
+    float fBrightnessOld = fBrightnesses[nSegment];
+    bool bPeakMarkerOld = bPeakMarkers[nSegment];
+
+    float fBrightness;
+
+    // current level lies above upper threshold
+    if (fLevel > fUpperThresholds[nSegment])
+    {
+        if (bDiscreteLevels[nSegment])
+        {
+            // set meter segment to dark
+            fBrightness = 0.25f;
+        }
+        else
+        {
+            // fully light meter segment
+            fBrightness = 0.97f;
+        }
+    }
+    // current level lies on or below lower threshold
+    else if (fLevel <= fLowerThresholds[nSegment])
+    {
+        // set meter segment to dark
+        fBrightness = 0.25f;
+    }
+    // current level lies within thresholds or on upper threshold
+    else
+    {
+        if (bDiscreteLevels[nSegment])
+        {
+            // fully light meter segment
+            fBrightness = 0.97f;
+        }
+        else
+        {
+            // calculate brightness from current level
+            fBrightness = (fLevel - fLowerThresholds[nSegment]) / fThresholdRanges[nSegment];
+
+            // to look well, meter segments should be left with some
+            // colour and not have maximum brightness
+            fBrightness = fBrightness * 0.72f + 0.25f;
+        }
+    }
+
+    fBrightnesses[nSegment] = fBrightness;
+
+    // peak lies within thresholds or on upper threshold, so show peak
+    // marker on segment
+    if ((fLevelPeak > fLowerThresholds[nSegment]) && (fLevelPeak <= fUpperThresholds[nSegment]))
+    {
+        bPeakMarkers[nSegment] = displayPeaks;
+    }
+    // otherwise, do not show peak marker on segment
+    else
+    {
+        bPeakMarkers[nSegment] = false;
+    }
+
+    // sprites are quantised, so smaller changes in brightness do not
+    // show
+    bool bBrightnessChanged = (MeterSpriteCache::quantiseBrightness(fBrightnesses[nSegment]) != MeterSpriteCache::quantiseBrightness(fBrightnessOld));
+
+    return bBrightnessChanged || (bPeakMarkers[nSegment] != bPeakMarkerOld);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
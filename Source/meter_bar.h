@@ -0,0 +1,108 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_BAR_H__
+#define __METER_BAR_H__
+
+#include "JuceHeader.h"
+#include "meter_sprite_cache.h"
+
+
+//==============================================================================
+/**
+   Vertical meter bar made up of segments.  The bar is a single
+   component: segment thresholds, colours and brightness are kept in
+   flat arrays, all segments are blitted from shared sprites in one
+   "paint()", and segments that change on a level update are merged
+   into one dirty rectangle.  Derived classes define the segments.
+
+   Segments must be defined from top to bottom with falling,
+   non-overlapping thresholds.  A level can then be mapped to a
+   segment with a single binary search: all segments above are dark
+   and all segments below lie above their upper threshold.  Thus, a
+   level update only has to look at the segments between the old and
+   the new position (and at the old and new peak marker).
+*/
+class MeterBar : public Component
+{
+public:
+    MeterBar(const String &componentName, int pos_x, int pos_y, int width, int number_of_segments, int segment_height, bool display_peaks);
+    ~MeterBar();
+
+    virtual void setCrestFactor(int crest_factor) = 0;
+    int getNumberOfSegments();
+
+    void setLevels(float level, float levelPeak);
+    void paint(Graphics &g);
+    void resized();
+    void visibilityChanged();
+
+protected:
+    void resetLevels();
+    void setSegment(int nSegment, float fThreshold, float fRange, bool bDiscreteLevels, int nColor);
+
+private:
+    JUCE_LEAK_DETECTOR(MeterBar);
+
+    float fLevel;
+    float fLevelPeak;
+
+    int nPosX;
+    int nPosY;
+    int nWidth;
+    int nHeight;
+    int nSegmentHeight;
+    int nNumberOfSegments;
+    bool displayPeaks;
+
+    // first segment whose lower threshold lies below the current
+    // level (nNumberOfSegments if there is none)
+    int nLevelSegment;
+
+    // segment showing the peak marker (-1 if there is none)
+    int nPeakSegment;
+
+    float *fLowerThresholds;
+    float *fUpperThresholds;
+    float *fThresholdRanges;
+    float *fHues;
+    float *fBrightnesses;
+    bool *bDiscreteLevels;
+    bool *bPeakMarkers;
+
+    SharedResourcePointer<MeterSpriteCache> spriteCache;
+
+    int findSegment(float fLevelToFind);
+    bool updateSegment(int nSegment);
+    Rectangle<int> getSegmentBounds(int nSegment);
+};
+
+
+#endif  // __METER_BAR_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
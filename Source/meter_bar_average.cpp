@@ -25,30 +25,29 @@
 
 #include "meter_bar_average.h"
 
-MeterBarAverage::MeterBarAverage(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters)
+MeterBarAverage::MeterBarAverage(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters) : MeterBar(componentName, pos_x, pos_y, width, number_of_bars, segment_height, display_peaks)
 {
-    setName(componentName);
+    bShowCombinedMeters = show_combined_meters;
+    setCrestFactor(crest_factor);
+}
 
-    // this component does not have any transparent areas (increases
-    // performance on redrawing)
-    setOpaque(true);
 
-    nNumberOfBars = number_of_bars;
-    nSegmentHeight = segment_height;
+void MeterBarAverage::setCrestFactor(int crest_factor)
+/*  (Re-)define all segments for a crest factor.  The bar is
+    retargeted in place and starts dark.
 
-    nPosX = pos_x;
-    nPosY = pos_y;
-    nWidth = width;
-    nHeight = nNumberOfBars * nSegmentHeight + 1;
+    crest_factor (integer): meter crest factor (0 or 20 dB)
 
-    int nCrestFactor = 10 * crest_factor;
-    fAverageLevel = 0.0f;
-    fAverageLevelPeak = 0.0f;
+    return value: none
+*/
+{
+    // darken all segments before they are redefined
+    resetLevels();
 
-    pMeterSegments = new MeterSegment*[nNumberOfBars];
+    int nCrestFactor = 10 * crest_factor;
 
     int n = 0;
-    int nThreshold = show_combined_meters ? -100 : -170;
+    int nThreshold = bShowCombinedMeters ? -100 : -170;
     nThreshold += nCrestFactor;
     int nTrueThreshold = nThreshold - nCrestFactor;
 
@@ -57,10 +56,9 @@ MeterBarAverage::MeterBarAverage(const String &componentName, int pos_x, int pos
     int nColor = 0;
     bool bDiscreteLevels = true;
 
-    pMeterSegments[n] = new MeterSegment("MeterSegment #" + String(n) + " (" + componentName + ")", nThreshold * 0.1f, fRange, bDiscreteLevels, display_peaks, nColor);
-    addAndMakeVisible(pMeterSegments[n]);
+    setSegment(n, nThreshold * 0.1f, fRange, bDiscreteLevels, nColor);
 
-    for (int n = 1; n < nNumberOfBars; n++)
+    for (int n = 1; n < getNumberOfSegments(); n++)
     {
         int nThresholdDifference;
 
@@ -100,65 +98,7 @@ MeterBarAverage::MeterBarAverage(const String &componentName, int pos_x, int pos
             nColor = 3;
         }
 
-        pMeterSegments[n] = new MeterSegment("MeterSegment #" + String(n) + " (" + componentName + ")", nThreshold * 0.1f, fRange, bDiscreteLevels, display_peaks, nColor);
-        addAndMakeVisible(pMeterSegments[n]);
-    }
-}
-
-
-MeterBarAverage::~MeterBarAverage()
-{
-    for (int n = 0; n < nNumberOfBars; n++)
-    {
-        removeChildComponent(pMeterSegments[n]);
-        delete pMeterSegments[n];
-        pMeterSegments[n] = nullptr;
-    }
-
-    delete [] pMeterSegments;
-    pMeterSegments = nullptr;
-
-    deleteAllChildren();
-}
-
-
-void MeterBarAverage::visibilityChanged()
-{
-    setBounds(nPosX, nPosY, nWidth, nHeight);
-
-    int x = 0;
-    int y = 0;
-
-    for (int n = 0; n < nNumberOfBars; n++)
-    {
-        pMeterSegments[n]->setBounds(x, y, nWidth, nSegmentHeight + 1);
-        y += nSegmentHeight;
-    }
-}
-
-
-void MeterBarAverage::paint(Graphics &g)
-{
-    g.fillAll(Colours::black);
-}
-
-
-void MeterBarAverage::resized()
-{
-}
-
-
-void MeterBarAverage::setLevels(float averageLevel, float averageLevelPeak)
-{
-    if ((averageLevel != fAverageLevel) || (averageLevelPeak != fAverageLevelPeak))
-    {
-        fAverageLevel = averageLevel;
-        fAverageLevelPeak = averageLevelPeak;
-
-        for (int n = 0; n < nNumberOfBars; n++)
-        {
-            pMeterSegments[n]->setLevels(fAverageLevel, fAverageLevelPeak);
-        }
+        setSegment(n, nThreshold * 0.1f, fRange, bDiscreteLevels, nColor);
     }
 }
 
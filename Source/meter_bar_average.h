@@ -27,37 +27,23 @@
 #define __METER_BAR_AVERAGE_H__
 
 #include "JuceHeader.h"
-#include "meter_segment.h"
+#include "meter_bar.h"
 
 
 //==============================================================================
 /**
 */
-class MeterBarAverage : public Component
+class MeterBarAverage : public MeterBar
 {
 public:
     MeterBarAverage(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters);
-    ~MeterBarAverage();
 
-    void setLevels(float averageLevel, float averageLevelPeak);
-    void paint(Graphics &g);
-    void resized();
-    void visibilityChanged();
+    void setCrestFactor(int crest_factor);
 
 private:
     JUCE_LEAK_DETECTOR(MeterBarAverage);
 
-    float fAverageLevel;
-    float fAverageLevelPeak;
-
-    int nPosX;
-    int nPosY;
-    int nWidth;
-    int nHeight;
-    int nSegmentHeight;
-    int nNumberOfBars;
-
-    MeterSegment **pMeterSegments;
+    bool bShowCombinedMeters;
 };
 
 
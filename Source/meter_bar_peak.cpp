@@ -25,30 +25,28 @@
 
 #include "meter_bar_peak.h"
 
-MeterBarPeak::MeterBarPeak(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters)
+MeterBarPeak::MeterBarPeak(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters) : MeterBar(componentName, pos_x, pos_y, width, number_of_bars, segment_height, display_peaks)
 {
-    setName(componentName);
+    bShowCombinedMeters = show_combined_meters;
+    setCrestFactor(crest_factor);
+}
 
-    // this component does not have any transparent areas (increases
-    // performance on redrawing)
-    setOpaque(true);
 
-    nNumberOfBars = number_of_bars;
-    nSegmentHeight = segment_height;
+void MeterBarPeak::setCrestFactor(int crest_factor)
+/*  (Re-)define all segments for a crest factor.  The bar is
+    retargeted in place and starts dark.
 
-    nPosX = pos_x;
-    nPosY = pos_y;
-    nWidth = width;
-    nHeight = nNumberOfBars * nSegmentHeight + 1;
+    crest_factor (integer): meter crest factor (0 or 20 dB)
 
-    int nCrestFactor = 10 * crest_factor;
-    fPeakLevel = -9999.8f;
-    fPeakLevelPeak = -9999.8f;
-    fPeakLevelMaximum = -9999.8f;
+    return value: none
+*/
+{
+    // darken all segments before they are redefined
+    resetLevels();
 
-    pMeterSegments = new MeterSegment*[nNumberOfBars];
+    int nCrestFactor = 10 * crest_factor;
 
-    int nThreshold = show_combined_meters ? -90 : -90;
+    int nThreshold = bShowCombinedMeters ? -90 : -90;
     nThreshold += nCrestFactor;
     int nTrueThreshold = nThreshold - nCrestFactor;
 
@@ -57,7 +55,7 @@ MeterBarPeak::MeterBarPeak(const String &componentName, int pos_x, int pos_y, in
     int nColor = 0;
     bool bDiscreteLevels = true;
 
-    for (int n = 0; n < nNumberOfBars; n++)
+    for (int n = 0; n < getNumberOfSegments(); n++)
     {
         int nThresholdDifference;
 
@@ -97,65 +95,7 @@ MeterBarPeak::MeterBarPeak(const String &componentName, int pos_x, int pos_y, in
             nColor = 3;
         }
 
-        pMeterSegments[n] = new MeterSegment("MeterSegment #" + String(n) + " (" + componentName + ")", nThreshold * 0.1f, fRange, bDiscreteLevels, display_peaks, nColor);
-        addAndMakeVisible(pMeterSegments[n]);
-    }
-}
-
-
-MeterBarPeak::~MeterBarPeak()
-{
-    for (int n = 0; n < nNumberOfBars; n++)
-    {
-        removeChildComponent(pMeterSegments[n]);
-        delete pMeterSegments[n];
-        pMeterSegments[n] = nullptr;
-    }
-
-    delete [] pMeterSegments;
-    pMeterSegments = nullptr;
-
-    deleteAllChildren();
-}
-
-
-void MeterBarPeak::visibilityChanged()
-{
-    setBounds(nPosX, nPosY, nWidth, nHeight);
-
-    int x = 0;
-    int y = 0;
-
-    for (int n = 0; n < nNumberOfBars; n++)
-    {
-        pMeterSegments[n]->setBounds(x, y, nWidth, nSegmentHeight + 1);
-        y += nSegmentHeight;
-    }
-}
-
-
-void MeterBarPeak::paint(Graphics &g)
-{
-    g.fillAll(Colours::black);
-}
-
-
-void MeterBarPeak::resized()
-{
-}
-
-
-void MeterBarPeak::setLevels(float peakLevel, float peakLevelPeak)
-{
-    if ((peakLevel != fPeakLevel) || (peakLevelPeak != fPeakLevelPeak))
-    {
-        fPeakLevel = peakLevel;
-        fPeakLevelPeak = peakLevelPeak;
-
-        for (int n = 0; n < nNumberOfBars; n++)
-        {
-            pMeterSegments[n]->setLevels(fPeakLevel, fPeakLevelPeak);
-        }
+        setSegment(n, nThreshold * 0.1f, fRange, bDiscreteLevels, nColor);
     }
 }
 
@@ -27,38 +27,23 @@
 #define __METER_BAR_PEAK_H__
 
 #include "JuceHeader.h"
-#include "meter_segment.h"
+#include "meter_bar.h"
 
 
 //==============================================================================
 /**
 */
-class MeterBarPeak : public Component
+class MeterBarPeak : public MeterBar
 {
 public:
     MeterBarPeak(const String &componentName, int pos_x, int pos_y, int width, int number_of_bars, int crest_factor, int segment_height, bool display_peaks, bool show_combined_meters);
-    ~MeterBarPeak();
 
-    void setLevels(float peakLevel, float peakLevelPeak);
-    void paint(Graphics &g);
-    void resized();
-    void visibilityChanged();
+    void setCrestFactor(int crest_factor);
 
 private:
     JUCE_LEAK_DETECTOR(MeterBarPeak);
 
-    float fPeakLevel;
-    float fPeakLevelPeak;
-    float fPeakLevelMaximum;
-
-    int nPosX;
-    int nPosY;
-    int nWidth;
-    int nHeight;
-    int nSegmentHeight;
-    int nNumberOfBars;
-
-    MeterSegment **pMeterSegments;
+    bool bShowCombinedMeters;
 };
 
 
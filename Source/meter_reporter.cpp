@@ -0,0 +1,474 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_reporter.h"
+
+
+MeterReporter::MeterReporter(const String &report_name, int number_of_channels, float sample_rate, int crest_factor)
+/*  Constructor.
+
+    report_name (String): name that prefixes all messages
+
+    number_of_channels (integer): number of audio channels
+
+    sample_rate (float): sample rate (used for time codes)
+
+    crest_factor (integer): meter's crest factor in decibel
+
+    return value: none
+*/
+{
+    strReportName = report_name;
+    nNumberOfChannels = number_of_channels;
+    fSampleRate = sample_rate;
+    nPosition = 0;
+
+    nReportChannel = -1;
+    bReports = false;
+    bReportCSV = false;
+    bReportAverageMeterLevel = false;
+    bReportPeakMeterLevel = false;
+
+    bHeaderIsWritten = false;
+    pReportStream = nullptr;
+    pMessageStream = nullptr;
+    setCrestFactor(crest_factor);
+
+    // try "300" for uncorrelated band-limited pink noise
+    nSamplesMovingAverage = 50;
+
+    fCurrentAverageLevels = new float[nNumberOfChannels];
+    fCurrentPeakLevels = new float[nNumberOfChannels];
+
+    pAverager_AverageMeterLevels = new Averager*[nNumberOfChannels];
+    pAverager_PeakMeterLevels = new Averager*[nNumberOfChannels];
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        pAverager_AverageMeterLevels[nChannel] = new Averager(nSamplesMovingAverage, fMeterMinimumDecibel);
+        pAverager_PeakMeterLevels[nChannel] = new Averager(nSamplesMovingAverage, fMeterMinimumDecibel);
+    }
+}
+
+
+MeterReporter::~MeterReporter()
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        delete pAverager_AverageMeterLevels[nChannel];
+        pAverager_AverageMeterLevels[nChannel] = nullptr;
+
+        delete pAverager_PeakMeterLevels[nChannel];
+        pAverager_PeakMeterLevels[nChannel] = nullptr;
+    }
+
+    delete [] pAverager_AverageMeterLevels;
+    pAverager_AverageMeterLevels = nullptr;
+
+    delete [] pAverager_PeakMeterLevels;
+    pAverager_PeakMeterLevels = nullptr;
+
+    delete [] fCurrentAverageLevels;
+    fCurrentAverageLevels = nullptr;
+
+    delete [] fCurrentPeakLevels;
+    fCurrentPeakLevels = nullptr;
+}
+
+
+void MeterReporter::setCrestFactor(int crest_factor)
+{
+    fCrestFactor = float(crest_factor);
+    fMeterMinimumDecibel = MeterBallistics::getMeterMinimumDecibel() + fCrestFactor;
+}
+
+
+void MeterReporter::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
+{
+    bReportCSV = ReportCSV;
+
+    nReportChannel = nChannel;
+    bReportAverageMeterLevel = bAverageMeterLevel;
+    bReportPeakMeterLevel = bPeakMeterLevel;
+
+    bReports = bReportAverageMeterLevel || bReportPeakMeterLevel;
+}
+
+
+void MeterReporter::setOutputStreams(OutputStream *report_stream, OutputStream *message_stream)
+/*  Select where reports and messages are written to.
+
+    report_stream (pointer to OutputStream): stream for meter
+    readings, or nullptr for the debug log
+
+    message_stream (pointer to OutputStream): stream for messages, or
+    nullptr for the debug log
+
+    return value: none
+*/
+{
+    pReportStream = report_stream;
+    pMessageStream = message_stream;
+}
+
+
+void MeterReporter::setPosition(int64 nSamplePosition)
+/*  Set current playback position (used for time codes).
+
+    nSamplePosition (64-bit integer): position in samples
+
+    return value: none
+*/
+{
+    nPosition = nSamplePosition;
+}
+
+
+bool MeterReporter::isReporting()
+{
+    return bReports;
+}
+
+
+void MeterReporter::disableReports()
+{
+    bReports = false;
+}
+
+
+void MeterReporter::outputReport(MeterBallistics *pMeterBallistics)
+/*  Report current meter readings (if any reports are selected).
+
+    pMeterBallistics (pointer to MeterBallistics): meter readings
+
+    return value: none
+*/
+{
+    if (bReports)
+    {
+        for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+        {
+            fCurrentAverageLevels[nChannel] = pMeterBallistics->getAverageMeterLevel(nChannel);
+            fCurrentPeakLevels[nChannel] = pMeterBallistics->getPeakMeterLevel(nChannel);
+        }
+
+        outputReport(fCurrentAverageLevels, fCurrentPeakLevels);
+    }
+}
+
+
+void MeterReporter::outputReport(const float *fAverageMeterLevels, const float *fPeakMeterLevels)
+/*  Report meter readings that have been captured earlier (if any
+    reports are selected).
+
+    fAverageMeterLevels (float array): average meter level of every
+    channel
+
+    fPeakMeterLevels (float array): peak meter level of every channel
+
+    return value: none
+*/
+{
+    if (bReports)
+    {
+        if (bReportCSV)
+        {
+            outputReportCSVLine(fAverageMeterLevels, fPeakMeterLevels);
+        }
+        else
+        {
+            outputReportPlain(fAverageMeterLevels, fPeakMeterLevels);
+        }
+    }
+}
+
+
+void MeterReporter::outputReportPlain(const float *fAverageMeterLevels, const float *fPeakMeterLevels)
+{
+    if (bReportAverageMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                float fAverageMeterLevel = fAverageMeterLevels[nChannel];
+                String strPrefix = "average level (ch. " + String(nChannel + 1) + "):  ";
+                String strSuffix = " dB";
+                outputValue(fAverageMeterLevel, pAverager_AverageMeterLevels[nChannel], fCrestFactor, strPrefix, strSuffix);
+            }
+        }
+        else
+        {
+            float fAverageMeterLevel = fAverageMeterLevels[nReportChannel];
+            String strPrefix = "average level (ch. " + String(nReportChannel + 1) + "):  ";
+            String strSuffix = " dB";
+            outputValue(fAverageMeterLevel, pAverager_AverageMeterLevels[nReportChannel], fCrestFactor, strPrefix, strSuffix);
+        }
+    }
+
+    if (bReportPeakMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                float fPeakMeterLevel = fPeakMeterLevels[nChannel];
+                String strPrefix = "peak level (ch. " + String(nChannel + 1) + "):     ";
+                String strSuffix = " dB";
+                outputValue(fPeakMeterLevel, pAverager_PeakMeterLevels[nChannel], fCrestFactor, strPrefix, strSuffix);
+            }
+        }
+        else
+        {
+            float fPeakMeterLevel = fPeakMeterLevels[nReportChannel];
+            String strPrefix = "peak level (ch. " + String(nReportChannel + 1) + "):     ";
+            String strSuffix = " dB";
+            outputValue(fPeakMeterLevel, pAverager_PeakMeterLevels[nReportChannel], fCrestFactor, strPrefix, strSuffix);
+        }
+    }
+
+    outputLine(formatMessage(String::empty));
+}
+
+
+void MeterReporter::outputReportCSVHeader(void)
+{
+    bHeaderIsWritten = true;
+    String strOutput = "\"timecode\"\t";
+
+    if (bReportAverageMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                strOutput += "\"avg_" + String(nChannel + 1) + "\"\t";
+            }
+        }
+        else
+        {
+            strOutput += "\"avg_" + String(nReportChannel + 1) + "\"\t";
+        }
+    }
+
+    if (bReportPeakMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                strOutput += "\"pk_" + String(nChannel + 1) + "\"\t";
+            }
+        }
+        else
+        {
+            strOutput += "\"pk_" + String(nReportChannel + 1) + "\"\t";
+        }
+    }
+
+    outputLine(strOutput);
+}
+
+
+void MeterReporter::outputReportCSVLine(const float *fAverageMeterLevels, const float *fPeakMeterLevels)
+{
+    String strOutput;
+
+    if (!bHeaderIsWritten)
+    {
+        outputReportCSVHeader();
+    }
+
+    if (bReportAverageMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                float fAverageMeterLevel = fAverageMeterLevels[nChannel];
+                strOutput += formatValue(fAverageMeterLevel);
+            }
+        }
+        else
+        {
+            float fAverageMeterLevel = fAverageMeterLevels[nReportChannel];
+            strOutput += formatValue(fAverageMeterLevel);
+        }
+    }
+
+    if (bReportPeakMeterLevel)
+    {
+        if (nReportChannel < 0)
+        {
+            for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+            {
+                float fPeakMeterLevel = fPeakMeterLevels[nChannel];
+                strOutput += formatValue(fPeakMeterLevel);
+            }
+        }
+        else
+        {
+            float fPeakMeterLevel = fPeakMeterLevels[nReportChannel];
+            strOutput += formatValue(fPeakMeterLevel);
+        }
+    }
+
+    outputLine("\"" + formatTime() + "\"\t" + strOutput);
+}
+
+
+String MeterReporter::formatTime(void)
+{
+    float fTime = nPosition / fSampleRate;
+
+    // check for NaN
+    if (fTime != fTime)
+    {
+        fTime = 0.0f;
+    }
+
+    int nTime = int(fTime);
+    int nMilliSeconds = int(1000.0f * (fTime - nTime) + 0.5f);
+
+    String strMinutes = String(nTime / 60).paddedLeft('0', 2);
+    String strSeconds = String(nTime % 60).paddedLeft('0', 2);
+    String strMilliSeconds = String(nMilliSeconds).paddedLeft('0', 3);
+
+    return strMinutes + ":" + strSeconds + "." + strMilliSeconds;
+}
+
+
+String MeterReporter::formatValue(const float fValue)
+{
+    String strValue;
+
+    if (fValue < 0.0f)
+    {
+        strValue = String(fValue, 2);
+    }
+    else
+    {
+        strValue = "+" + String(fValue, 2);
+    }
+
+    return (strValue + "\t");
+}
+
+
+void MeterReporter::outputValue(const float fValue, Averager *pAverager, const float fCorrectionFactor, const String &strPrefix, const String &strSuffix)
+{
+    String strValue;
+
+    if (fValue < 0.0f)
+    {
+        strValue = String(fValue, 2) + strSuffix;
+    }
+    else
+    {
+        strValue = "+" + String(fValue, 2) + strSuffix;
+    }
+
+    String strSimpleMovingAverage;
+
+    if (pAverager)
+    {
+        pAverager->addSample(fValue - fCorrectionFactor);
+
+        if (pAverager->isValid())
+        {
+            float fSimpleMovingAverage = pAverager->getSimpleMovingAverage() + fCorrectionFactor;
+
+            if (fSimpleMovingAverage < 0.0f)
+            {
+                strSimpleMovingAverage = "   SMA(" + String(nSamplesMovingAverage) + "): " + String(fSimpleMovingAverage, 2) + strSuffix;
+            }
+            else
+            {
+                strSimpleMovingAverage = "   SMA(" + String(nSamplesMovingAverage) + "): +" + String(fSimpleMovingAverage, 2) + strSuffix;
+            }
+        }
+    }
+
+    outputLine(formatMessage(strPrefix + strValue + strSimpleMovingAverage));
+}
+
+
+void MeterReporter::outputSummary(MeterBallistics *pMeterBallistics)
+/*  Report maximum peak levels and overflows since the meter was last
+    reset.
+
+    pMeterBallistics (pointer to MeterBallistics): meter readings
+
+    return value: none
+*/
+{
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        String strPrefix = "maximum peak level (ch. " + String(nChannel + 1) + "):  ";
+        String strValue = formatValue(pMeterBallistics->getMaximumPeakLevel(nChannel)).trimEnd();
+        String strOverflows = String(pMeterBallistics->getNumberOfOverflows(nChannel));
+
+        outputMessage(strPrefix + strValue + " dB   overflows: " + strOverflows);
+    }
+}
+
+
+void MeterReporter::outputMessage(const String &strMessage)
+{
+    String strOutput = formatMessage(strMessage);
+
+    if (pMessageStream)
+    {
+        *pMessageStream << strOutput << "\n";
+    }
+    else
+    {
+        Logger::outputDebugString(strOutput);
+    }
+}
+
+
+String MeterReporter::formatMessage(const String &strMessage)
+{
+    return "[" + strReportName + " - " + formatTime() + "] " + strMessage;
+}
+
+
+void MeterReporter::outputLine(const String &strLine)
+{
+    if (pReportStream)
+    {
+        *pReportStream << strLine << "\n";
+    }
+    else
+    {
+        Logger::outputDebugString(strLine);
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
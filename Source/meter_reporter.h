@@ -0,0 +1,106 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_REPORTER_H__
+#define __METER_REPORTER_H__
+
+class MeterReporter;
+
+#include "JuceHeader.h"
+#include "averager.h"
+#include "meter_ballistics.h"
+
+
+//==============================================================================
+/**
+   Formats meter readings as plain text (including simple moving
+   averages) or as tab-separated CSV.  Used by validation and by the
+   command-line analyser, so that both produce identical reports.
+*/
+class MeterReporter
+{
+public:
+    MeterReporter(const String &report_name, int number_of_channels, float sample_rate, int crest_factor);
+    ~MeterReporter();
+
+    void setCrestFactor(int crest_factor);
+    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    void setOutputStreams(OutputStream *report_stream, OutputStream *message_stream);
+    void setPosition(int64 nSamplePosition);
+
+    bool isReporting();
+    void disableReports();
+
+    void outputReport(MeterBallistics *pMeterBallistics);
+    void outputReport(const float *fAverageMeterLevels, const float *fPeakMeterLevels);
+    void outputSummary(MeterBallistics *pMeterBallistics);
+    void outputMessage(const String &strMessage);
+
+private:
+    JUCE_LEAK_DETECTOR(MeterReporter);
+
+    String strReportName;
+    bool bHeaderIsWritten;
+    int nSamplesMovingAverage;
+    int64 nPosition;
+    float fSampleRate;
+    float fCrestFactor;
+    float fMeterMinimumDecibel;
+
+    int nNumberOfChannels;
+    int nReportChannel;
+    bool bReports;
+    bool bReportCSV;
+    bool bReportAverageMeterLevel;
+    bool bReportPeakMeterLevel;
+
+    // meter readings captured by "outputReport(MeterBallistics *)"
+    float *fCurrentAverageLevels;
+    float *fCurrentPeakLevels;
+
+    Averager **pAverager_AverageMeterLevels;
+    Averager **pAverager_PeakMeterLevels;
+
+    OutputStream *pReportStream;
+    OutputStream *pMessageStream;
+
+    void outputReportPlain(const float *fAverageMeterLevels, const float *fPeakMeterLevels);
+    void outputReportCSVHeader(void);
+    void outputReportCSVLine(const float *fAverageMeterLevels, const float *fPeakMeterLevels);
+
+    String formatTime(void);
+    String formatValue(const float fValue);
+    String formatMessage(const String &strMessage);
+
+    void outputValue(const float fValue, Averager *pAverager, const float fCorrectionFactor, const String &strPrefix, const String &strSuffix);
+    void outputLine(const String &strLine);
+};
+
+#endif   // __METER_REPORTER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
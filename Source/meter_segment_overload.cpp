@@ -34,26 +34,6 @@ MeterSegmentOverload::MeterSegmentOverload(const String &componentName, float fT
     // display thick border on meter segment?
     hasThickBorder = bThickBorder;
 
-    // lower threshold, meter segment will be dark below this level
-    fLowerThreshold = fThreshold;
-
-    // level range above lower threshold; this affects the brightness
-    fThresholdRange = fRange;
-
-    // upper threshold, meter segment will be fully lit above this
-    // level
-    fUpperThreshold = fThreshold + fThresholdRange;
-
-    // meter crest factor
-    nCrestFactor = CrestFactor;
-
-    // show peak level marker on segment?
-    bPeakMarker = false;
-
-    // initialise meter segment's brightness (0.0f is dark, 1.0f is
-    // fully lit)
-    fBrightness = 0.0f;
-
     // set meter segment's hue from colour number
     if (nColor == 0)
     {
@@ -76,12 +56,7 @@ MeterSegmentOverload::MeterSegmentOverload(const String &componentName, float fT
         fHue = 0.58f;
     }
 
-    // initialise maximum level
-    fMaximumLevel = -9999.9f;
-    strMaximumLevel = String::empty;
-
-    // make sure that segment is drawn after initialisation
-    setLevels(-9999.9f, -9999.9f, -9999.9f);
+    setThresholds(fThreshold, fRange, CrestFactor);
 }
 
 
@@ -91,71 +66,83 @@ MeterSegmentOverload::~MeterSegmentOverload()
 }
 
 
-void MeterSegmentOverload::paint(Graphics &g)
+void MeterSegmentOverload::setThresholds(float fThreshold, float fRange, int CrestFactor)
+/*  (Re-)define thresholds of meter segment in place.  The segment
+    starts dark and without maximum level.
+
+    fThreshold (float): lower threshold; the segment will be dark
+    below this level
+
+    fRange (float): level range above lower threshold; this affects
+    the brightness
+
+    CrestFactor (integer): meter crest factor
+
+    return value: none
+*/
 {
-    // get meter segment's screen dimensions
-    int width = getWidth();
-    int height = getHeight();
+    // lower threshold, meter segment will be dark below this level
+    fLowerThreshold = fThreshold;
 
-    // initialise meter segment's colour from hue and brightness
-    g.setColour(Colour(fHue, 1.0f, fBrightness, 1.0f));
+    // level range above lower threshold; this affects the brightness
+    fThresholdRange = fRange;
 
-    // fill meter segment with solid colour, but leave a border for
-    // peak marker
-    if (hasThickBorder)
-    {
-        g.fillRect(2, 2, width - 4, height - 4);
-    }
-    else
+    // upper threshold, meter segment will be fully lit above this
+    // level
+    fUpperThreshold = fThreshold + fThresholdRange;
+
+    // meter crest factor
+    nCrestFactor = CrestFactor;
+
+    // show peak level marker on segment?
+    bPeakMarker = false;
+
+    // initialise meter segment's brightness (0.0f is dark, 1.0f is
+    // fully lit)
+    fBrightness = 0.0f;
+
+    // initialise maximum level
+    fMaximumLevel = -9999.9f;
+    strMaximumLevel = String::empty;
+
+    // make sure that segment is drawn after initialisation
+    setLevels(-9999.9f, -9999.9f, -9999.9f);
+}
+
+
+void MeterSegmentOverload::paint(Graphics &g)
+{
+    // blit pre-rendered segment (shared between all meters)
+    Image imageSegment = spriteCache->getOverloadSegment(getWidth(), getHeight(), fHue, fBrightness, bPeakMarker, hasThickBorder);
+    g.drawImageAt(imageSegment, 0, 0);
+
+    // the maximum level changes all the time, so draw it on top of
+    // the cached segment
+    if (strMaximumLevel.isEmpty())
     {
-        g.fillRect(1, 1, width - 2, height - 2);
+        return;
     }
 
-    // if peak marker is lit, draw a rectangle around meter segment
-    // (width: 1 pixel)
-    if (bPeakMarker)
+    // unlit segments draw their label in the colour of the border
+    if (fBrightness > 0.25f)
     {
-        if (hasThickBorder)
-        {
-            g.setColour(Colour(fHue, 1.0f, 1.0f, 1.0f));
-        }
-        else
-        {
-            g.setColour(Colour(fHue, 0.7f, 1.0f, 1.0f));
-        }
+        g.setColour(Colours::white);
     }
-    else
+    else if (!bPeakMarker)
     {
         g.setColour(Colours::black);
     }
-
-    if (hasThickBorder)
+    else if (hasThickBorder)
     {
-        g.drawRect(0, 0, width, height);
-        g.drawRect(1, 1, width - 2, height - 2);
-
-        // darken space between border and meter segment (width: 1 pixel)
-        if (fBrightness > 0.25f)
-        {
-            float fAlphaSpace = 0.385f;
-            g.setColour(Colour(0.00f, 1.0f, 0.00f, fAlphaSpace));
-            g.drawRect(2, 2, width - 4, height - 4);
-        }
+        g.setColour(Colour(fHue, 1.0f, 1.0f, 1.0f));
     }
     else
     {
-        g.drawRect(0, 0, width, height);
-    }
-
-
-    if (fBrightness > 0.25f)
-    {
-        g.setColour(Colours::white);
+        g.setColour(Colour(fHue, 0.7f, 1.0f, 1.0f));
     }
 
     g.setFont(11);
-    g.drawFittedText(strMaximumLevel, 2, 2, width - 6, height - 4, Justification::centred, 1, 0.7f);
-
+    g.drawFittedText(strMaximumLevel, 2, 2, getWidth() - 6, getHeight() - 4, Justification::centred, 1, 0.7f);
 }
 
 
@@ -27,6 +27,7 @@
 #define __METER_SEGMENT_OVERLOAD_H__
 
 #include "JuceHeader.h"
+#include "meter_sprite_cache.h"
 #include "mz_tools.h"
 
 
@@ -39,6 +40,7 @@ public:
     MeterSegmentOverload(const String &componentName, float fThreshold, float fRange, int nCrestFactor, bool bThickBorder, int nColor);
     ~MeterSegmentOverload();
 
+    void setThresholds(float fThreshold, float fRange, int CrestFactor);
     void setLevels(float fLevel, float fLevelPeak, float fLevelMaximum);
     void paint(Graphics &g);
     void resized();
@@ -60,6 +62,8 @@ private:
 
     bool bPeakMarker;
     bool hasThickBorder;
+
+    SharedResourcePointer<MeterSpriteCache> spriteCache;
 };
 
 
@@ -34,6 +34,28 @@ MeterSignalLed::MeterSignalLed(const String &componentName, String &label, float
     // set label
     strLabel = label;
 
+    setThresholds(fThreshold, fRange);
+}
+
+
+MeterSignalLed::~MeterSignalLed()
+{
+    // nothing to do, really
+}
+
+
+void MeterSignalLed::setThresholds(float fThreshold, float fRange)
+/*  (Re-)define thresholds of LED in place.  The LED starts dark.
+
+    fThreshold (float): lower threshold; the LED will be dark below
+    this level
+
+    fRange (float): level range above lower threshold; this affects
+    the brightness
+
+    return value: none
+*/
+{
     // lower threshold, meter segment will be dark below this level
     fLowerThreshold = fThreshold;
 
@@ -47,49 +69,16 @@ MeterSignalLed::MeterSignalLed(const String &componentName, String &label, float
     // initialise meter segment's brightness (0.0f is dark, 1.0f is
     // fully lit)
     fBrightness = 0.0f;
-}
-
 
-MeterSignalLed::~MeterSignalLed()
-{
-    // nothing to do, really
+    repaint();
 }
 
 
 void MeterSignalLed::paint(Graphics &g)
 {
-    // get meter segment's screen dimensions
-    int width = getWidth();
-    int height = getHeight();
-
-    // meter segment is blue
-    float fHue = 0.60f;
-
-    // initialise meter segment's colour from hue and brightness
-    g.setColour(Colour(fHue, 0.9f, fBrightness, 1.0f));
-
-    // fill meter segment with solid colour, but leave a border of one
-    // pixel for peak marker
-    g.fillRect(1, 1, width - 2, height - 2);
-
-    // initialise color for label (light blue for levels below the
-    // threshold and black for all other levels)
-    if (fBrightness <= 0.32f)
-    {
-        g.setColour(Colour(fHue, 0.4f, 0.75f, 1.0f));
-    }
-    else
-    {
-        g.setColour(Colours::black);
-    }
-
-    // draw label
-    g.setFont(12.0f);
-    g.drawFittedText(strLabel, 0, 1, width, 10, Justification::centred, 1, 1.0f);
-
-    // draw a black rectangle around meter segment (width: 1 pixel)
-    g.setColour(Colours::black);
-    g.drawRect(0, 0, width, height);
+    // blit pre-rendered LED (shared between all meters)
+    Image imageLed = spriteCache->getSignalLed(getWidth(), getHeight(), fBrightness, strLabel);
+    g.drawImageAt(imageLed, 0, 0);
 }
 
 
@@ -133,8 +122,9 @@ void MeterSignalLed::setLevel(float fLevel)
         fBrightness = fBrightness * 0.65f + 0.32f;
     }
 
-    // re-paint meter segment only when the brightness has changed
-    if (fBrightness != fBrightnessOld)
+    // re-paint meter segment only when the brightness has visibly
+    // changed (sprites are quantised)
+    if (MeterSpriteCache::quantiseBrightness(fBrightness) != MeterSpriteCache::quantiseBrightness(fBrightnessOld))
     {
         repaint(getLocalBounds());
     }
@@ -27,6 +27,7 @@
 #define __METER_SIGNAL_LED_H__
 
 #include "JuceHeader.h"
+#include "meter_sprite_cache.h"
 
 
 //==============================================================================
@@ -38,6 +39,7 @@ public:
     MeterSignalLed(const String &componentName, String &label, float fThreshold, float fRange);
     ~MeterSignalLed();
 
+    void setThresholds(float fThreshold, float fRange);
     void setLevel(float fLevel);
     void paint(Graphics &g);
     void resized();
@@ -52,6 +54,8 @@ private:
     float fLowerThreshold;
     float fUpperThreshold;
     float fThresholdRange;
+
+    SharedResourcePointer<MeterSpriteCache> spriteCache;
 };
 
 
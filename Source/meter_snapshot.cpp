@@ -0,0 +1,216 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_snapshot.h"
+
+
+void MeterSnapshot::clear(float fMinimumDecibel)
+/*  Reset all meter readings.
+
+    fMinimumDecibel (float): meter's minimum level in decibels
+
+    return value: none
+*/
+{
+    nNumberOfChannels = JucePlugin_MaxNumInputChannels;
+
+    for (int nChannel = 0; nChannel < JucePlugin_MaxNumInputChannels; nChannel++)
+    {
+        fPeakMeterLevels[nChannel] = fMinimumDecibel;
+        fPeakMeterPeakLevels[nChannel] = fMinimumDecibel;
+
+        fAverageMeterLevels[nChannel] = fMinimumDecibel;
+        fAverageMeterPeakLevels[nChannel] = fMinimumDecibel;
+
+        fPeakMeterSignals[nChannel] = fMinimumDecibel;
+        fMaximumPeakLevels[nChannel] = fMinimumDecibel;
+        nNumberOfOverflows[nChannel] = 0;
+    }
+}
+
+
+int MeterSnapshot::getNumberOfChannels() const
+{
+    return nNumberOfChannels;
+}
+
+
+float MeterSnapshot::getPeakMeterLevel(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fPeakMeterLevels[nChannel];
+}
+
+
+float MeterSnapshot::getPeakMeterPeakLevel(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fPeakMeterPeakLevels[nChannel];
+}
+
+
+float MeterSnapshot::getAverageMeterLevel(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fAverageMeterLevels[nChannel];
+}
+
+
+float MeterSnapshot::getAverageMeterPeakLevel(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fAverageMeterPeakLevels[nChannel];
+}
+
+
+float MeterSnapshot::getPeakMeterSignal(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fPeakMeterSignals[nChannel];
+}
+
+
+float MeterSnapshot::getMaximumPeakLevel(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return fMaximumPeakLevels[nChannel];
+}
+
+
+int MeterSnapshot::getNumberOfOverflows(int nChannel) const
+{
+    jassert(isPositiveAndBelow(nChannel, JucePlugin_MaxNumInputChannels));
+
+    return nNumberOfOverflows[nChannel];
+}
+
+
+//==============================================================================
+
+MeterSnapshotPublisher::MeterSnapshotPublisher(float fMinimumDecibel)
+{
+    // "new" does not guarantee the alignment of frames, so allocate
+    // some extra memory and align the frames by hand
+    size_t uSizeSnapshots = 3 * sizeof(MeterSnapshot);
+    size_t uSizeIndices = nNumIndices * sizeof(SnapshotIndex);
+
+    pMemory.allocate(uSizeSnapshots + uSizeIndices + METER_SNAPSHOT_ALIGNMENT, true);
+
+    pointer_sized_int nAddress = reinterpret_cast<pointer_sized_int>(pMemory.getData());
+    nAddress = (nAddress + METER_SNAPSHOT_ALIGNMENT - 1) & ~((pointer_sized_int) METER_SNAPSHOT_ALIGNMENT - 1);
+
+    pSnapshots = reinterpret_cast<MeterSnapshot *>(nAddress);
+    pIndices = reinterpret_cast<SnapshotIndex *>(nAddress + uSizeSnapshots);
+
+    for (int nSnapshot = 0; nSnapshot < 3; nSnapshot++)
+    {
+        pSnapshots[nSnapshot].clear(fMinimumDecibel);
+    }
+
+    pIndices[indexWriter].nIndex = 0;
+    pIndices[indexExchange].nIndex = 1;
+    pIndices[indexReader].nIndex = 2;
+}
+
+
+MeterSnapshotPublisher::~MeterSnapshotPublisher()
+{
+    pSnapshots = nullptr;
+    pIndices = nullptr;
+}
+
+
+MeterSnapshot *MeterSnapshotPublisher::getWriteBuffer()
+/*  Get frame owned by the audio thread.  Only call this from the audio
+    thread!
+
+    return value (pointer to MeterSnapshot): frame to be filled
+*/
+{
+    return &pSnapshots[pIndices[indexWriter].nIndex.get()];
+}
+
+
+void MeterSnapshotPublisher::publish()
+/*  Publish the frame returned by getWriteBuffer() and take over the
+    exchanged frame.  Only call this from the audio thread!
+
+    return value: none
+*/
+{
+    // make sure that the frame has been written completely before it
+    // is handed over
+    Atomic<int>::memoryBarrier();
+
+    int nNewIndex = pIndices[indexWriter].nIndex.get() | nNewSnapshotFlag;
+    int nOldIndex = pIndices[indexExchange].nIndex.exchange(nNewIndex);
+
+    pIndices[indexWriter].nIndex = nOldIndex & ~nNewSnapshotFlag;
+}
+
+
+bool MeterSnapshotPublisher::hasNewSnapshot()
+/*  Check whether a frame has been published since the last call of
+    getLatestSnapshot().  Only call this from the editor!
+
+    return value (Boolean): true if a new frame is available
+*/
+{
+    return (pIndices[indexExchange].nIndex.get() & nNewSnapshotFlag) != 0;
+}
+
+
+const MeterSnapshot *MeterSnapshotPublisher::getLatestSnapshot()
+/*  Get newest complete frame.  Only call this from the editor!
+
+    return value (pointer to MeterSnapshot): newest frame; it remains
+    valid until this function is called again
+*/
+{
+    if (hasNewSnapshot())
+    {
+        int nNewIndex = pIndices[indexReader].nIndex.get();
+        int nOldIndex = pIndices[indexExchange].nIndex.exchange(nNewIndex);
+
+        pIndices[indexReader].nIndex = nOldIndex & ~nNewSnapshotFlag;
+
+        // make sure that the frame is not read before it has been
+        // taken over
+        Atomic<int>::memoryBarrier();
+    }
+
+    return &pSnapshots[pIndices[indexReader].nIndex.get()];
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
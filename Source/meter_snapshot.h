@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_SNAPSHOT_H__
+#define __METER_SNAPSHOT_H__
+
+// size of a cache line on current processors
+#define METER_SNAPSHOT_ALIGNMENT 64
+
+#if JUCE_MSVC
+#define METER_SNAPSHOT_ALIGN __declspec(align(METER_SNAPSHOT_ALIGNMENT))
+#else
+#define METER_SNAPSHOT_ALIGN __attribute__((aligned(METER_SNAPSHOT_ALIGNMENT)))
+#endif
+
+#include "JuceHeader.h"
+
+
+//==============================================================================
+/**
+   Plain frame holding all meter readings of a single update.  Levels
+   are stored in decibels and already include the crest factor, so the
+   editor can use them as they are.
+
+   Frames are aligned to cache lines, so that the editor reading one
+   frame never shares a cache line with the audio thread writing
+   another one.
+*/
+struct METER_SNAPSHOT_ALIGN MeterSnapshot
+{
+    int nNumberOfChannels;
+
+    float fPeakMeterLevels[JucePlugin_MaxNumInputChannels];
+    float fPeakMeterPeakLevels[JucePlugin_MaxNumInputChannels];
+
+    float fAverageMeterLevels[JucePlugin_MaxNumInputChannels];
+    float fAverageMeterPeakLevels[JucePlugin_MaxNumInputChannels];
+
+    float fPeakMeterSignals[JucePlugin_MaxNumInputChannels];
+    float fMaximumPeakLevels[JucePlugin_MaxNumInputChannels];
+    int nNumberOfOverflows[JucePlugin_MaxNumInputChannels];
+
+    void clear(float fMinimumDecibel);
+
+    int getNumberOfChannels() const;
+
+    float getPeakMeterLevel(int nChannel) const;
+    float getPeakMeterPeakLevel(int nChannel) const;
+
+    float getAverageMeterLevel(int nChannel) const;
+    float getAverageMeterPeakLevel(int nChannel) const;
+
+    float getPeakMeterSignal(int nChannel) const;
+    float getMaximumPeakLevel(int nChannel) const;
+    int getNumberOfOverflows(int nChannel) const;
+};
+
+
+//==============================================================================
+/**
+   Lock-free triple buffer for passing meter snapshots from the audio
+   thread (single writer) to the editor (single reader).  The writer
+   always owns one frame, the reader always owns another one, and the
+   third frame is exchanged atomically.  Thus, neither thread ever
+   blocks, and the reader always sees the newest complete frame.
+*/
+class MeterSnapshotPublisher
+{
+public:
+    MeterSnapshotPublisher(float fMinimumDecibel);
+    ~MeterSnapshotPublisher();
+
+    // audio thread
+    MeterSnapshot *getWriteBuffer();
+    void publish();
+
+    // editor
+    bool hasNewSnapshot();
+    const MeterSnapshot *getLatestSnapshot();
+
+private:
+    JUCE_LEAK_DETECTOR(MeterSnapshotPublisher);
+
+    // marks the exchanged frame as not yet read
+    static const int nNewSnapshotFlag = 4;
+
+    // owned by either thread; each index lives in its own cache line
+    struct METER_SNAPSHOT_ALIGN SnapshotIndex
+    {
+        Atomic<int> nIndex;
+    };
+
+    HeapBlock<char> pMemory;
+
+    MeterSnapshot *pSnapshots;
+    SnapshotIndex *pIndices;
+
+    enum Indices
+    {
+        indexWriter = 0,
+        indexExchange,
+        indexReader,
+
+        nNumIndices
+    };
+};
+
+
+#endif  // __METER_SNAPSHOT_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
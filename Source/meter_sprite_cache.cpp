@@ -0,0 +1,344 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "meter_sprite_cache.h"
+
+
+MeterSpriteCache::MeterSpriteCache()
+{
+}
+
+
+MeterSpriteCache::~MeterSpriteCache()
+{
+    clear();
+}
+
+
+int MeterSpriteCache::quantiseBrightness(float fBrightness)
+/*  Quantise brightness to the resolution of "Colour".
+
+    fBrightness (float): brightness (0.0 to 1.0)
+
+    return value (integer): quantised brightness (0 to 255)
+*/
+{
+    return jlimit(0, 255, roundToInt(fBrightness * 255.0f));
+}
+
+
+int MeterSpriteCache::getNumberOfSprites()
+{
+    return sprites.size();
+}
+
+
+void MeterSpriteCache::clear()
+{
+    // components keep references to their current sprites, so these
+    // stay valid
+    sprites.clear();
+    strLedLabels.clear();
+}
+
+
+int MeterSpriteCache::getLabelIndex(const String &strLabel)
+/*  Get index of LED label, adding it if necessary.  Does not allocate
+    memory for known labels.
+
+    strLabel (String): LED label
+
+    return value (integer): index of label
+*/
+{
+    int nIndex = strLedLabels.indexOf(strLabel);
+
+    if (nIndex < 0)
+    {
+        nIndex = strLedLabels.size();
+        strLedLabels.add(strLabel);
+    }
+
+    return nIndex;
+}
+
+
+void MeterSpriteCache::limitSize()
+{
+    if (getNumberOfSprites() >= nMaximumSprites)
+    {
+        clear();
+    }
+}
+
+
+Image MeterSpriteCache::getSegment(int nWidth, int nHeight, float fHue, float fBrightness, SegmentBorder border)
+/*  Get sprite of a meter bar segment.  Unlit borders are transparent
+    for "borderNone", so that neighbouring segments can share a row of
+    pixels.
+
+    nWidth (integer): segment width (including border)
+
+    nHeight (integer): segment height (including border)
+
+    fHue (float): segment hue
+
+    fBrightness (float): segment brightness
+
+    border (SegmentBorder): border type
+
+    return value (Image): pre-rendered segment
+*/
+{
+    jassert((nWidth > 0) && (nWidth < 4096));
+    jassert((nHeight > 0) && (nHeight < 4096));
+
+    int nBrightness = quantiseBrightness(fBrightness);
+    int nHue = roundToInt(fHue * 1000.0f);
+
+    int64 nKey = int64(nWidth) |
+                 (int64(nHeight) << 12) |
+                 (int64(nHue) << 24) |
+                 (int64(nBrightness) << 35) |
+                 (int64(border) << 43) |
+                 (int64(spriteSegment) << 56);
+
+    if (sprites.contains(nKey))
+    {
+        return sprites[nKey];
+    }
+
+    limitSize();
+
+    Image imageSegment(Image::ARGB, nWidth, nHeight, true);
+    Graphics g(imageSegment);
+
+    // initialise meter segment's colour from hue and brightness
+    g.setColour(Colour(fHue, 1.0f, nBrightness / 255.0f, 1.0f));
+
+    // fill meter segment with solid colour, but leave a border of one
+    // pixel for peak marker
+    g.fillRect(1, 1, nWidth - 2, nHeight - 2);
+
+    // if peak marker is lit, draw a rectangle around meter segment
+    // (width: 1 pixel)
+    if (border == borderPeakMarker)
+    {
+        g.setColour(Colour(fHue, 0.7f, 1.0f, 1.0f));
+        g.drawRect(0, 0, nWidth, nHeight);
+    }
+    else if (border == borderBlack)
+    {
+        g.setColour(Colours::black);
+        g.drawRect(0, 0, nWidth, nHeight);
+    }
+
+    sprites.set(nKey, imageSegment);
+    return imageSegment;
+}
+
+
+Image MeterSpriteCache::getOverloadSegment(int nWidth, int nHeight, float fHue, float fBrightness, bool bPeakMarker, bool bThickBorder)
+/*  Get sprite of an overload segment.  The label showing the maximum
+    level is drawn by the segment itself.
+
+    nWidth (integer): segment width
+
+    nHeight (integer): segment height
+
+    fHue (float): segment hue
+
+    fBrightness (float): segment brightness
+
+    bPeakMarker (Boolean): draw peak marker
+
+    bThickBorder (Boolean): draw thick border
+
+    return value (Image): pre-rendered segment
+*/
+{
+    jassert((nWidth > 0) && (nWidth < 4096));
+    jassert((nHeight > 0) && (nHeight < 4096));
+
+    int nBrightness = quantiseBrightness(fBrightness);
+    int nHue = roundToInt(fHue * 1000.0f);
+
+    // decide on lighting before quantisation (just like the original
+    // drawing code)
+    bool bLit = (fBrightness > 0.25f);
+
+    int64 nKey = int64(nWidth) |
+                 (int64(nHeight) << 12) |
+                 (int64(nHue) << 24) |
+                 (int64(nBrightness) << 35) |
+                 (int64(bLit) << 43) |
+                 (int64(bPeakMarker) << 44) |
+                 (int64(bThickBorder) << 45) |
+                 (int64(spriteOverloadSegment) << 56);
+
+    if (sprites.contains(nKey))
+    {
+        return sprites[nKey];
+    }
+
+    limitSize();
+
+    Image imageSegment(Image::ARGB, nWidth, nHeight, true);
+    Graphics g(imageSegment);
+
+    // initialise meter segment's colour from hue and brightness
+    g.setColour(Colour(fHue, 1.0f, nBrightness / 255.0f, 1.0f));
+
+    // fill meter segment with solid colour, but leave a border for
+    // peak marker
+    if (bThickBorder)
+    {
+        g.fillRect(2, 2, nWidth - 4, nHeight - 4);
+    }
+    else
+    {
+        g.fillRect(1, 1, nWidth - 2, nHeight - 2);
+    }
+
+    // if peak marker is lit, draw a rectangle around meter segment
+    // (width: 1 pixel)
+    if (bPeakMarker)
+    {
+        if (bThickBorder)
+        {
+            g.setColour(Colour(fHue, 1.0f, 1.0f, 1.0f));
+        }
+        else
+        {
+            g.setColour(Colour(fHue, 0.7f, 1.0f, 1.0f));
+        }
+    }
+    else
+    {
+        g.setColour(Colours::black);
+    }
+
+    if (bThickBorder)
+    {
+        g.drawRect(0, 0, nWidth, nHeight);
+        g.drawRect(1, 1, nWidth - 2, nHeight - 2);
+
+        // darken space between border and meter segment (width: 1 pixel)
+        if (bLit)
+        {
+            float fAlphaSpace = 0.385f;
+            g.setColour(Colour(0.00f, 1.0f, 0.00f, fAlphaSpace));
+            g.drawRect(2, 2, nWidth - 4, nHeight - 4);
+        }
+    }
+    else
+    {
+        g.drawRect(0, 0, nWidth, nHeight);
+    }
+
+    sprites.set(nKey, imageSegment);
+    return imageSegment;
+}
+
+
+Image MeterSpriteCache::getSignalLed(int nWidth, int nHeight, float fBrightness, const String &strLabel)
+/*  Get sprite of a signal LED, including its label.
+
+    nWidth (integer): LED width
+
+    nHeight (integer): LED height
+
+    fBrightness (float): LED brightness
+
+    strLabel (String): LED label
+
+    return value (Image): pre-rendered LED
+*/
+{
+    jassert((nWidth > 0) && (nWidth < 4096));
+    jassert((nHeight > 0) && (nHeight < 4096));
+
+    int nBrightness = quantiseBrightness(fBrightness);
+
+    // decide on label colour before quantisation (just like the
+    // original drawing code)
+    bool bDark = (fBrightness <= 0.32f);
+
+    // limit size before looking up the label, as clearing the cache
+    // also forgets all labels
+    limitSize();
+
+    int64 nKey = int64(nWidth) |
+                 (int64(nHeight) << 12) |
+                 (int64(nBrightness) << 24) |
+                 (int64(bDark) << 32) |
+                 (int64(getLabelIndex(strLabel)) << 33) |
+                 (int64(spriteSignalLed) << 56);
+
+    if (sprites.contains(nKey))
+    {
+        return sprites[nKey];
+    }
+
+    Image imageLed(Image::ARGB, nWidth, nHeight, true);
+    Graphics g(imageLed);
+
+    // meter segment is blue
+    float fHue = 0.60f;
+
+    // initialise meter segment's colour from hue and brightness
+    g.setColour(Colour(fHue, 0.9f, nBrightness / 255.0f, 1.0f));
+
+    // fill meter segment with solid colour, but leave a border of one
+    // pixel for peak marker
+    g.fillRect(1, 1, nWidth - 2, nHeight - 2);
+
+    // initialise color for label (light blue for levels below the
+    // threshold and black for all other levels)
+    if (bDark)
+    {
+        g.setColour(Colour(fHue, 0.4f, 0.75f, 1.0f));
+    }
+    else
+    {
+        g.setColour(Colours::black);
+    }
+
+    // draw label
+    g.setFont(12.0f);
+    g.drawFittedText(strLabel, 0, 1, nWidth, 10, Justification::centred, 1, 1.0f);
+
+    // draw a black rectangle around meter segment (width: 1 pixel)
+    g.setColour(Colours::black);
+    g.drawRect(0, 0, nWidth, nHeight);
+
+    sprites.set(nKey, imageLed);
+    return imageLed;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
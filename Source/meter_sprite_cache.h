@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __METER_SPRITE_CACHE_H__
+#define __METER_SPRITE_CACHE_H__
+
+#include "JuceHeader.h"
+
+
+//==============================================================================
+/**
+   Process-wide cache of pre-rendered meter segments and labelled
+   LEDs.  Segments only ever take a small number of sizes, hues and
+   peak marker states, so painting a meter comes down to blitting
+   images.  Overload segments are cached without their label, as
+   the maximum level it shows changes all the time.  Obtain the cache through "SharedResourcePointer" so that
+   all plugin instances in a process share the same sprites.
+
+   Brightness is quantised to 8 bits (the resolution of "Colour"), so
+   sprites look exactly like directly painted segments.  All
+   functions must be called from the message thread.
+*/
+class MeterSpriteCache
+{
+public:
+    enum SegmentBorder
+    {
+        borderNone = 0,
+        borderBlack,
+        borderPeakMarker
+    };
+
+    MeterSpriteCache();
+    ~MeterSpriteCache();
+
+    static int quantiseBrightness(float fBrightness);
+
+    Image getSegment(int nWidth, int nHeight, float fHue, float fBrightness, SegmentBorder border);
+    Image getOverloadSegment(int nWidth, int nHeight, float fHue, float fBrightness, bool bPeakMarker, bool bThickBorder);
+    Image getSignalLed(int nWidth, int nHeight, float fBrightness, const String &strLabel);
+
+    int getNumberOfSprites();
+    void clear();
+
+private:
+    JUCE_LEAK_DETECTOR(MeterSpriteCache);
+
+    // sprites are only a few hundred bytes each; this limit is never
+    // reached by the meters, but keeps the cache from growing without
+    // bounds on unusual layouts
+    static const int nMaximumSprites = 4096;
+
+    // kept in the upper bits of the key of every sprite
+    enum SpriteType
+    {
+        spriteSegment = 0,
+        spriteOverloadSegment,
+        spriteSignalLed
+    };
+
+    int getLabelIndex(const String &strLabel);
+
+    HashMap<int64, Image> sprites;
+
+    // labels of signal LEDs (only a few, so keys can refer to their
+    // index instead of holding a copy)
+    StringArray strLedLabels;
+
+    void limitSize();
+};
+
+
+#endif  // __METER_SPRITE_CACHE_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -206,12 +206,40 @@ void PeakMeter::resized()
 }
 
 
-void PeakMeter::setLevels(MeterBallistics *pMeterBallistics)
+void PeakMeter::setCrestFactor(int CrestFactor)
+/*  Retarget thresholds and scale to a new crest factor in place
+    (without re-creating any components).
+
+    CrestFactor (integer): meter crest factor (0 or 20 dB)
+
+    return value: none
+*/
+{
+    nCrestFactor = CrestFactor;
+
+    int nThreshold = -90;
+    nThreshold += nCrestFactor * 10;
+
+    // register all hot signals, even up to +100 dB FS!
+    float fRange = ((nCrestFactor * 10) - nThreshold) * 0.1f + 100.0f;
+
+    for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
+    {
+        LevelMeters[nChannel]->setCrestFactor(nCrestFactor);
+        MeterSegmentOverloads[nChannel]->setThresholds(nThreshold * 0.1f, fRange, nCrestFactor);
+    }
+
+    // re-draw scale
+    repaint();
+}
+
+
+void PeakMeter::setLevels(const MeterSnapshot *pMeterSnapshot)
 {
     for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
     {
-        LevelMeters[nChannel]->setLevels(pMeterBallistics->getPeakMeterLevel(nChannel), pMeterBallistics->getPeakMeterPeakLevel(nChannel));
-        MeterSegmentOverloads[nChannel]->setLevels(pMeterBallistics->getPeakMeterLevel(nChannel), pMeterBallistics->getPeakMeterPeakLevel(nChannel), pMeterBallistics->getMaximumPeakLevel(nChannel));
+        LevelMeters[nChannel]->setLevels(pMeterSnapshot->getPeakMeterLevel(nChannel), pMeterSnapshot->getPeakMeterPeakLevel(nChannel));
+        MeterSegmentOverloads[nChannel]->setLevels(pMeterSnapshot->getPeakMeterLevel(nChannel), pMeterSnapshot->getPeakMeterPeakLevel(nChannel), pMeterSnapshot->getMaximumPeakLevel(nChannel));
     }
 }
 
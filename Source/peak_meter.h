@@ -43,7 +43,8 @@ public:
     PeakMeter(const String &componentName, int PosX, int PosY, int width, int CrestFactor, int nNumChannels, int segment_height);
     ~PeakMeter();
 
-    void setLevels(MeterBallistics *pMeterBallistics);
+    void setCrestFactor(int CrestFactor);
+    void setLevels(const MeterSnapshot *pMeterSnapshot);
     void paint(Graphics &g);
     int getPreferredHeight();
     void resized();
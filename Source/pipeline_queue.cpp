@@ -0,0 +1,166 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "pipeline_queue.h"
+
+
+PipelineQueue::PipelineQueue(int number_of_slots) : fifo(number_of_slots + 1)
+/*  Constructor.
+
+    number_of_slots (integer): number of slots that may be in the
+    queue at the same time
+
+    return value: none
+*/
+{
+    // AbstractFifo always keeps one element free, so the actual
+    // number of slots is one more than usable
+    nNumberOfSlots = number_of_slots + 1;
+
+    nIsClosed = 0;
+    nIsCancelled = 0;
+}
+
+
+PipelineQueue::~PipelineQueue()
+{
+}
+
+
+int PipelineQueue::getNumberOfSlots()
+/*  Get number of slots, which is the size of the caller's payload
+    arrays.
+
+    return value (integer): number of slots
+*/
+{
+    return nNumberOfSlots;
+}
+
+
+bool PipelineQueue::startWriting(int &nSlot)
+/*  Producer: wait for a free slot.  Call "finishWriting()" once the
+    slot has been filled.
+
+    nSlot (integer reference): receives number of free slot
+
+    return value (Boolean): false if the queue has been cancelled
+*/
+{
+    while (nIsCancelled.get() == 0)
+    {
+        int nStart1, nSize1, nStart2, nSize2;
+        fifo.prepareToWrite(1, nStart1, nSize1, nStart2, nSize2);
+
+        if (nSize1 > 0)
+        {
+            nSlot = nStart1;
+            return true;
+        }
+
+        eventDataRead.wait(nWaitTimeout);
+    }
+
+    return false;
+}
+
+
+void PipelineQueue::finishWriting()
+{
+    fifo.finishedWrite(1);
+    eventDataWritten.signal();
+}
+
+
+bool PipelineQueue::startReading(int &nSlot)
+/*  Consumer: wait for a filled slot.  Call "finishReading()" once
+    the slot may be re-used.
+
+    nSlot (integer reference): receives number of filled slot
+
+    return value (Boolean): false if the queue has been closed and
+    all slots have been read, or if the queue has been cancelled
+*/
+{
+    while (nIsCancelled.get() == 0)
+    {
+        // read flag first: the producer closes the queue only after
+        // writing its last slot
+        bool bIsClosed = (nIsClosed.get() != 0);
+
+        int nStart1, nSize1, nStart2, nSize2;
+        fifo.prepareToRead(1, nStart1, nSize1, nStart2, nSize2);
+
+        if (nSize1 > 0)
+        {
+            nSlot = nStart1;
+            return true;
+        }
+        else if (bIsClosed)
+        {
+            return false;
+        }
+
+        eventDataWritten.wait(nWaitTimeout);
+    }
+
+    return false;
+}
+
+
+void PipelineQueue::finishReading()
+{
+    fifo.finishedRead(1);
+    eventDataRead.signal();
+}
+
+
+void PipelineQueue::close()
+/*  Producer: signal that no more slots will be written.
+
+    return value: none
+*/
+{
+    nIsClosed = 1;
+    eventDataWritten.signal();
+}
+
+
+void PipelineQueue::cancel()
+/*  Stop both stages without waiting for remaining slots.
+
+    return value: none
+*/
+{
+    nIsCancelled = 1;
+
+    eventDataWritten.signal();
+    eventDataRead.signal();
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
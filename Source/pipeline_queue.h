@@ -0,0 +1,80 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __PIPELINE_QUEUE_H__
+#define __PIPELINE_QUEUE_H__
+
+class PipelineQueue;
+
+#include "JuceHeader.h"
+
+
+//==============================================================================
+/**
+   Bounded single-producer, single-consumer queue of slot numbers.
+   The payload lives in arrays owned by the caller and indexed by
+   slot, so passing data between two pipeline stages neither copies
+   nor allocates.  A full queue blocks the producer and an empty
+   queue blocks the consumer, which keeps memory usage constant.
+*/
+class PipelineQueue
+{
+public:
+    PipelineQueue(int number_of_slots);
+    ~PipelineQueue();
+
+    int getNumberOfSlots();
+
+    bool startWriting(int &nSlot);
+    void finishWriting();
+
+    bool startReading(int &nSlot);
+    void finishReading();
+
+    void close();
+    void cancel();
+
+private:
+    JUCE_LEAK_DETECTOR(PipelineQueue);
+
+    // maximum time to wait for the other stage in milliseconds
+    static const int nWaitTimeout = 10;
+
+    int nNumberOfSlots;
+
+    AbstractFifo fifo;
+    WaitableEvent eventDataWritten;
+    WaitableEvent eventDataRead;
+
+    Atomic<int> nIsClosed;
+    Atomic<int> nIsCancelled;
+};
+
+#endif   // __PIPELINE_QUEUE_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -44,7 +44,7 @@ TraKmeterAudioProcessorEditor::TraKmeterAudioProcessorEditor(TraKmeterAudioProce
     // and labels will be set later on in this constructor.
 
     pProcessor = ownerFilter;
-    pProcessor->addActionListener(this);
+    pProcessor->addUpdateListener(this);
 
     ButtonMeterType = new TextButton("Meter");
     ButtonMeterType->setColour(TextButton::buttonColourId, Colours::grey);
@@ -123,12 +123,17 @@ TraKmeterAudioProcessorEditor::TraKmeterAudioProcessorEditor(TraKmeterAudioProce
     updateParameter(TraKmeterPluginParameters::selMixMode);
     updateParameter(TraKmeterPluginParameters::selGain);
     updateParameter(TraKmeterPluginParameters::selMeterType);
+
+    // pull meter readings once per frame, independent of the sample
+    // rate
+    frameScheduler->addClient(this);
 }
 
 
 TraKmeterAudioProcessorEditor::~TraKmeterAudioProcessorEditor()
 {
-    pProcessor->removeActionListener(this);
+    frameScheduler->removeClient(this);
+    pProcessor->removeUpdateListener(this);
 
     deleteAllChildren();
 }
@@ -159,53 +164,54 @@ void TraKmeterAudioProcessorEditor::resizeEditor()
 }
 
 
-void TraKmeterAudioProcessorEditor::actionListenerCallback(const String &strMessage)
+void TraKmeterAudioProcessorEditor::metersUpdated()
 {
-    // "PC" --> parameter changed, followed by a hash and the
-    // parameter's ID
-    if (strMessage.startsWith("PC#"))
-    {
-        String strIndex = strMessage.substring(3);
-        int nIndex = strIndex.getIntValue();
-        jassert(nIndex >= 0);
-        jassert(nIndex < pProcessor->getNumParameters());
+    trakmeter->setLevels(pProcessor->getLevels());
 
-        if (pProcessor->hasChanged(nIndex))
-        {
-            updateParameter(nIndex);
-        }
-    }
-    // "UM" --> update meters
-    else if (!strMessage.compare("UM"))
+    if (bIsValidating && !pProcessor->isValidating())
     {
-        MeterBallistics *pMeterBallistics = pProcessor->getLevels();
+        bIsValidating = false;
+        ButtonValidation->setToggleState(false, dontSendNotification);
+    }
+}
 
-        if (pMeterBallistics)
-        {
-            trakmeter->setLevels(pMeterBallistics);
-        }
 
-        if (bIsValidating && !pProcessor->isValidating())
-        {
-            bIsValidating = false;
-            ButtonValidation->setToggleState(false, dontSendNotification);
-        }
+void TraKmeterAudioProcessorEditor::frameTick()
+{
+    // collect parameter changes signalled since the last frame
+    pProcessor->deliverUpdates();
+    metersUpdated();
+}
+
+
+bool TraKmeterAudioProcessorEditor::isFrameVisible()
+{
+    // false when the editor (or its window) is hidden or minimised
+    return isShowing();
+}
+
+
+void TraKmeterAudioProcessorEditor::parameterChanged(int nIndex)
+{
+    jassert(nIndex >= 0);
+    jassert(nIndex < pProcessor->getNumParameters());
+
+    if (pProcessor->hasChanged(nIndex))
+    {
+        updateParameter(nIndex);
     }
-    // "V+" --> validation started
-    else if ((!strMessage.compare("V+")) && pProcessor->isValidating())
+}
+
+
+void TraKmeterAudioProcessorEditor::validationChanged(bool bValidationStarted)
+{
+    if (bValidationStarted && pProcessor->isValidating())
     {
         bIsValidating = true;
         ButtonValidation->setToggleState(true, dontSendNotification);
     }
-    // "V-" --> validation stopped
-    else if (!strMessage.compare("V-"))
-    {
-        // do nothing till you hear from me... :)
-    }
-    else
-    {
-        DBG("[traKmeter] Received unknown action message \"" + strMessage + "\".");
-    }
+
+    // validation stopped: do nothing till you hear from me... :)
 }
 
 
@@ -264,16 +270,20 @@ void TraKmeterAudioProcessorEditor::reloadMeters()
     {
         bReloadMeters = false;
 
+        int nMeterType = pProcessor->getRealInteger(TraKmeterPluginParameters::selMeterType);
+
+        // meters are retargeted in place, so toggling crest factor or
+        // meter type does not create any components
         if (trakmeter)
         {
-            removeChildComponent(trakmeter);
-            delete trakmeter;
-            trakmeter = nullptr;
+            trakmeter->setCrestFactor(nCrestFactor);
+            trakmeter->setMeterType(nMeterType);
+        }
+        else
+        {
+            trakmeter = new TraKmeter("traKmeter (level meter)", 10, 10, nCrestFactor, nInputChannels, nSegmentHeight, nMeterType);
+            addAndMakeVisible(trakmeter);
         }
-
-        int nMeterType = pProcessor->getRealInteger(TraKmeterPluginParameters::selMeterType);
-        trakmeter = new TraKmeter("traKmeter (level meter)", 10, 10, nCrestFactor, nInputChannels, nSegmentHeight, nMeterType);
-        addAndMakeVisible(trakmeter);
     }
 }
 
@@ -289,12 +299,7 @@ void TraKmeterAudioProcessorEditor::buttonClicked(Button *button)
 {
     if (button == ButtonReset)
     {
-        MeterBallistics *pMeterBallistics = pProcessor->getLevels();
-
-        if (pMeterBallistics)
-        {
-            pMeterBallistics->reset();
-        }
+        pProcessor->resetMeters();
     }
     else if (button == ButtonMeterType)
     {
@@ -27,6 +27,7 @@
 #define __PLUGINEDITOR_TRAKMETER_H__
 
 #include "JuceHeader.h"
+#include "frame_scheduler.h"
 #include "plugin_parameters.h"
 #include "plugin_processor.h"
 #include "parameter_juggler/slider_switch.h"
@@ -38,7 +39,7 @@
 //==============================================================================
 /**
 */
-class TraKmeterAudioProcessorEditor : public AudioProcessorEditor, public ButtonListener, public SliderListener, public ActionListener
+class TraKmeterAudioProcessorEditor : public AudioProcessorEditor, public ButtonListener, public SliderListener, public UpdateSignaller::Listener, public FrameScheduler::Client
 {
 public:
     TraKmeterAudioProcessorEditor(TraKmeterAudioProcessor *ownerFilter, TraKmeterPluginParameters *parameters, int nNumChannels, int CrestFactor);
@@ -47,7 +48,12 @@ public:
     void buttonClicked(Button *button);
     void sliderValueChanged(Slider *slider);
 
-    void actionListenerCallback(const String &strMessage);
+    void metersUpdated();
+    void frameTick();
+    bool isFrameVisible();
+
+    void parameterChanged(int nIndex);
+    void validationChanged(bool bValidationStarted);
     void updateParameter(int nIndex);
 
     //==============================================================================
@@ -85,6 +91,8 @@ private:
     SliderSwitch *SliderGain;
 
     Label *LabelDebug;
+
+    SharedResourcePointer<FrameScheduler> frameScheduler;
 };
 
 
@@ -100,6 +100,21 @@ TraKmeterPluginParameters::TraKmeterPluginParameters()
     add(ParameterMeterType, selMeterType);
 
 
+    ParameterHopSize = new WrappedParameterSwitch();
+    ParameterHopSize->setName("Hop size");
+
+    // values divide the analysis window (TRAKMETER_WINDOW_DURATION)
+    // into hops, labels show the resulting interval between meter
+    // updates
+    ParameterHopSize->addConstant(1.0f, "23 ms");
+    ParameterHopSize->addConstant(2.0f, "12 ms");
+    ParameterHopSize->addConstant(4.0f,  "6 ms");
+    ParameterHopSize->addConstant(8.0f,  "3 ms");
+
+    ParameterHopSize->setDefaultRealFloat(4.0f, true);
+    add(ParameterHopSize, selHopSize);
+
+
     ParameterValidationFileName = new WrappedParameterString(String::empty);
     ParameterValidationFileName->setName("Validation: file name");
     add(ParameterValidationFileName, selValidationFileName);
@@ -141,6 +156,18 @@ TraKmeterPluginParameters::TraKmeterPluginParameters()
     ParameterValidationCSVFormat->setName("Validation: CSV output format");
     ParameterValidationCSVFormat->setDefaultBoolean(false, true);
     add(ParameterValidationCSVFormat, selValidationCSVFormat);
+
+
+    ParameterValidationWriteToFile = new WrappedParameterToggleSwitch("Off", "On");
+    ParameterValidationWriteToFile->setName("Validation: write to file");
+    ParameterValidationWriteToFile->setDefaultBoolean(false, true);
+    add(ParameterValidationWriteToFile, selValidationWriteToFile);
+
+
+    ParameterValidationBinaryFormat = new WrappedParameterToggleSwitch("Off", "On");
+    ParameterValidationBinaryFormat->setName("Validation: binary output format");
+    ParameterValidationBinaryFormat->setDefaultBoolean(false, true);
+    add(ParameterValidationBinaryFormat, selValidationBinaryFormat);
 }
 
 
@@ -161,6 +188,9 @@ TraKmeterPluginParameters::~TraKmeterPluginParameters()
     delete ParameterMeterType;
     ParameterMeterType = nullptr;
 
+    delete ParameterHopSize;
+    ParameterHopSize = nullptr;
+
     delete ParameterValidationFileName;
     ParameterValidationFileName = nullptr;
 
@@ -175,6 +205,12 @@ TraKmeterPluginParameters::~TraKmeterPluginParameters()
 
     delete ParameterValidationCSVFormat;
     ParameterValidationCSVFormat = nullptr;
+
+    delete ParameterValidationWriteToFile;
+    ParameterValidationWriteToFile = nullptr;
+
+    delete ParameterValidationBinaryFormat;
+    ParameterValidationBinaryFormat = nullptr;
 }
 
 
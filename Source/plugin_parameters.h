@@ -53,6 +53,7 @@ public:
         selMixMode,
         selGain,
         selMeterType,
+        selHopSize,
 
         nNumParametersRevealed,
 
@@ -61,6 +62,8 @@ public:
         selValidationAverageMeterLevel,
         selValidationPeakMeterLevel,
         selValidationCSVFormat,
+        selValidationWriteToFile,
+        selValidationBinaryFormat,
 
         nNumParametersComplete,
 
@@ -78,12 +81,15 @@ private:
     WrappedParameterToggleSwitch  *ParameterMixMode;
     WrappedParameterSwitch        *ParameterGain;
     WrappedParameterSwitch        *ParameterMeterType;
+    WrappedParameterSwitch        *ParameterHopSize;
 
     WrappedParameterString        *ParameterValidationFileName;
     WrappedParameterSwitch        *ParameterValidationSelectedChannel;
     WrappedParameterToggleSwitch  *ParameterValidationAverageMeterLevel;
     WrappedParameterToggleSwitch  *ParameterValidationPeakMeterLevel;
     WrappedParameterToggleSwitch  *ParameterValidationCSVFormat;
+    WrappedParameterToggleSwitch  *ParameterValidationWriteToFile;
+    WrappedParameterToggleSwitch  *ParameterValidationBinaryFormat;
 };
 
 #endif  // __PLUGIN_PARAMETERS_TRAKMETER_H__
@@ -25,6 +25,7 @@
 
 #include "plugin_processor.h"
 #include "plugin_editor.h"
+#include "realtime_audit.h"
 
 
 /*==============================================================================
@@ -35,7 +36,11 @@ Flow of parameter processing:
   Processor:   changeParameter(nIndex, fValue)
   Processor:   setParameter(nIndex, fValue)
   Parameters:  setFloat(nIndex, fValue)
-  Editor:      actionListenerCallback(strMessage)
+  Signaller:   signalParameterChange(nIndex)
+  Editor:      frameTick()
+  Processor:   deliverUpdates()
+  Signaller:   deliverSignals()
+  Editor:      parameterChanged(nIndex)
   Editor:      updateParameter(nIndex)
 
 ==============================================================================*/
@@ -44,11 +49,25 @@ TraKmeterAudioProcessor::TraKmeterAudioProcessor()
 {
     bSampleRateIsValid = false;
     audioFilePlayer = nullptr;
+    nPlayerInUse = 0;
     pRingBufferInput = nullptr;
 
     nNumInputChannels = 0;
     pMeterBallistics = nullptr;
 
+    // the editor reads meter levels from here, so this must never
+    // be deleted while the processor is alive
+    pSnapshotPublisher = new MeterSnapshotPublisher(MeterBallistics::getMeterMinimumDecibel());
+    nResetMeters = 0;
+
+    // no changes of meter ballistics are pending
+    nPendingTransientMode = -1;
+    nPendingCrestFactor = -1;
+
+    // notifies the editor without allocating memory on the audio
+    // thread
+    pUpdateSignaller = new UpdateSignaller();
+
     setLatencySamples(0);
     pPluginParameters = new TraKmeterPluginParameters();
 
@@ -65,27 +84,37 @@ TraKmeterAudioProcessor::TraKmeterAudioProcessor()
     fRmsLevels = nullptr;
 
     nOverflows = nullptr;
+    nChannelCapacity = 0;
 
-    pDither = new Dither(24);
+    // allocated in "prepareToPlay()" for the actual number of
+    // channels
+    pDither = nullptr;
 }
 
 
 TraKmeterAudioProcessor::~TraKmeterAudioProcessor()
 {
-    removeAllActionListeners();
-
     // call function "releaseResources()" by force to make sure all
     // allocated memory is freed
     releaseResources();
+    freeMeterState();
 
     delete pPluginParameters;
     pPluginParameters = nullptr;
 
-    delete audioFilePlayer;
-    audioFilePlayer = nullptr;
+    deleteAudioFilePlayer();
 
-    delete pDither;
-    pDither = nullptr;
+    delete pSnapshotPublisher;
+    pSnapshotPublisher = nullptr;
+
+    delete pUpdateSignaller;
+    pUpdateSignaller = nullptr;
+
+#ifdef TRAKMETER_REALTIME_AUDIT
+    // list everything the audio thread should not have done
+    RealtimeAudit::printReport();
+    jassert(RealtimeAudit::getNumberOfViolations() == 0);
+#endif
 }
 
 
@@ -169,9 +198,7 @@ void TraKmeterAudioProcessor::setParameter(int nIndex, float fValue)
         // will also clear the change flag)
         if (nIndex < pPluginParameters->getNumParameters(false))
         {
-            // "PC" --> parameter changed, followed by a hash and the
-            // parameter's ID
-            sendActionMessage("PC#" + String(nIndex));
+            pUpdateSignaller->signalParameterChange(nIndex);
         }
         // for hidden parameters, we only have to clear the change
         // flag
@@ -225,6 +252,8 @@ void TraKmeterAudioProcessor::updateParameters(bool bIncludeHiddenParameters)
         // * selValidationAverageMeterLevel
         // * selValidationPeakMeterLevel
         // * selValidationCSVFormat
+        // * selValidationWriteToFile
+        // * selValidationBinaryFormat
 
     }
 }
@@ -393,12 +422,22 @@ void TraKmeterAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
 
     DBG("[traKmeter] number of input channels: " + String(nNumInputChannels));
 
-    pMeterBallistics = new MeterBallistics(nNumInputChannels, nCrestFactor, true, false, bTransientMode);
+    // per-channel scratch memory only grows (and is shared by all
+    // arrays), so hosts that re-prepare with fewer channels do not
+    // cause any allocations
+    if (nNumInputChannels > nChannelCapacity)
+    {
+        nChannelCapacity = nNumInputChannels;
+        pChannelMemory.allocate(nChannelCapacity * (2 * sizeof(float) + sizeof(int)), true);
 
-    fPeakLevels = new float[nNumInputChannels];
-    fRmsLevels = new float[nNumInputChannels];
+        fPeakLevels = reinterpret_cast<float *>(pChannelMemory.getData());
+        fRmsLevels = fPeakLevels + nChannelCapacity;
+        nOverflows = reinterpret_cast<int *>(fRmsLevels + nChannelCapacity);
 
-    nOverflows = new int[nNumInputChannels];
+        // dither keeps separate state for every channel
+        delete pDither;
+        pDither = new Dither(nChannelCapacity, 24);
+    }
 
     for (int nChannel = 0; nChannel < nNumInputChannels; nChannel++)
     {
@@ -408,14 +447,67 @@ void TraKmeterAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
         nOverflows[nChannel] = 0;
     }
 
-    // make sure that ring buffer can hold at least
-    // TRAKMETER_BUFFER_SIZE samples and is large enough to receive a
-    // full block of audio
-    nSamplesInBuffer = 0;
-    unsigned int uRingBufferSize = (samplesPerBlock > TRAKMETER_BUFFER_SIZE) ? samplesPerBlock : TRAKMETER_BUFFER_SIZE;
+    // derive analysis window and pre-delay from their durations
+    // (1024 and 512 samples at 44.1 kHz, 4459 and 2229 samples at
+    // 192 kHz)
+    unsigned int uWindowSize = (unsigned int) (TRAKMETER_WINDOW_DURATION * sampleRate / 1000.0 + 0.5);
+    unsigned int uPreDelay = uWindowSize / 2;
+    unsigned int uHopSize = getHopSize(uWindowSize);
+
+    DBG("[traKmeter] analysis window: " + String(uWindowSize) + " samples");
+
+    // make sure that ring buffer can hold the analysis window and is
+    // large enough to receive a full block of audio; add room for
+    // the largest hop (the whole window) so that the hop size can be
+    // changed without re-allocating the buffer
+    unsigned int uRingBufferSize = (samplesPerBlock > (int) uWindowSize) ? samplesPerBlock : uWindowSize;
+    uRingBufferSize += uWindowSize;
+
+    // hosts call this function on every change of transport or
+    // buffer size, so keep meter state unless its configuration has
+    // changed (a larger ring buffer works just as well)
+    bool bChannelsChanged = (pMeterBallistics == nullptr) || (pMeterBallistics->getNumberOfChannels() != nNumInputChannels);
+
+    if (bChannelsChanged)
+    {
+        // the validation player refers to the meter ballistics
+        if (audioFilePlayer.get())
+        {
+            stopValidation();
+        }
+
+        delete pMeterBallistics;
+        pMeterBallistics = new MeterBallistics(nNumInputChannels, nCrestFactor, true, false, bTransientMode);
+    }
+    else
+    {
+        pMeterBallistics->reset();
+    }
+
+    bool bReuseRingBuffer = !bChannelsChanged &&
+                            (pRingBufferInput != nullptr) &&
+                            (pRingBufferInput->getSlidingWindowSize() == uWindowSize) &&
+                            (pRingBufferInput->getPreDelay() == uPreDelay) &&
+                            (pRingBufferInput->getBufferLength() >= uRingBufferSize);
+
+    if (bReuseRingBuffer)
+    {
+        pRingBufferInput->clear();
+        pRingBufferInput->setChunkSize(uHopSize);
+    }
+    else
+    {
+        delete pRingBufferInput;
+
+        pRingBufferInput = new AudioRingBuffer("Input ring buffer", nNumInputChannels, uRingBufferSize, uPreDelay, uHopSize);
+        pRingBufferInput->setCallbackClass(this);
 
-    pRingBufferInput = new AudioRingBuffer("Input ring buffer", nNumInputChannels, uRingBufferSize, TRAKMETER_BUFFER_SIZE, TRAKMETER_BUFFER_SIZE);
-    pRingBufferInput->setCallbackClass(this);
+        // analyse the whole window after every hop (use pre-delay)
+        pRingBufferInput->enableSlidingWindow(uWindowSize, uPreDelay);
+    }
+
+    // any pending reset has just been done
+    nResetMeters = 0;
 }
 
 
@@ -426,28 +518,55 @@ void TraKmeterAudioProcessor::releaseResources()
 
     DBG("[traKmeter] in method TraKmeterAudioProcessor::releaseResources()");
 
-    if (!bSampleRateIsValid)
+    // meter state is kept for the next call of "prepareToPlay()" and
+    // freed in the destructor
+    deleteAudioFilePlayer();
+}
+
+
+void TraKmeterAudioProcessor::deleteAudioFilePlayer()
+/*  Detach validation player from the audio thread and delete it.
+    Only call this from the message thread.
+
+    return value: none
+*/
+{
+    AudioFilePlayer *pOldPlayer = audioFilePlayer.exchange(nullptr);
+
+    if (pOldPlayer == nullptr)
     {
         return;
     }
 
+    // users of the player mark it as used before fetching it, so
+    // once they have let go, they cannot see the old player anymore
+    while (nPlayerInUse.get() != 0)
+    {
+        Thread::sleep(1);
+    }
+
+    delete pOldPlayer;
+}
+
+
+void TraKmeterAudioProcessor::freeMeterState()
+{
     delete pMeterBallistics;
     pMeterBallistics = nullptr;
 
     delete pRingBufferInput;
     pRingBufferInput = nullptr;
 
-    delete [] fPeakLevels;
-    fPeakLevels = nullptr;
+    // per-channel arrays point into this block
+    pChannelMemory.free();
+    nChannelCapacity = 0;
 
-    delete [] fRmsLevels;
+    fPeakLevels = nullptr;
     fRmsLevels = nullptr;
-
-    delete [] nOverflows;
     nOverflows = nullptr;
 
-    delete audioFilePlayer;
-    audioFilePlayer = nullptr;
+    delete pDither;
+    pDither = nullptr;
 }
 
 
@@ -456,6 +575,10 @@ void TraKmeterAudioProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer
     // This is the place where you'd normally do the guts of your
     // plug-in's audio processing...
 
+    // check for allocations, locks and blocking system calls when
+    // compiled with TRAKMETER_REALTIME_AUDIT
+    TRAKMETER_AUDIO_THREAD_SCOPE;
+
     int nNumSamples = buffer.getNumSamples();
 
     if (!bSampleRateIsValid)
@@ -468,9 +591,11 @@ void TraKmeterAudioProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer
         return;
     }
 
+    // do not log anything here, as this allocates memory on the
+    // audio thread (and "prepareToPlay()" corrects the number of
+    // input channels anyway)
     if (nNumInputChannels < 1)
     {
-        Logger::outputDebugString("[traKmeter] nNumInputChannels < 1");
         return;
     }
 
@@ -483,105 +608,166 @@ void TraKmeterAudioProcessor::processBlock(AudioSampleBuffer &buffer, MidiBuffer
         buffer.clear(nChannel, 0, nNumSamples);
     }
 
-    if (audioFilePlayer)
+    // keep the message thread from deleting the player while it is
+    // in use (see "deleteAudioFilePlayer()")
+    ++nPlayerInUse;
+
+    AudioFilePlayer *pPlayer = audioFilePlayer.get();
+
+    if (pPlayer)
     {
-        audioFilePlayer->fillBufferChunk(&buffer);
+        pPlayer->fillBufferChunk(&buffer);
     }
 
+    --nPlayerInUse;
+
     bool bMixMode = getBoolean(TraKmeterPluginParameters::selMixMode);
 
     if (bMixMode && (nDecibels != 0))
     {
-        for (int nChannel = 0; nChannel < buffer.getNumChannels(); nChannel++)
+        // output channels without input have been cleared above
+        int nNumChannels = jmin(buffer.getNumChannels(), nNumInputChannels);
+
+        for (int nChannel = 0; nChannel < nNumChannels; nChannel++)
         {
-            for (int nSample = 0; nSample < buffer.getNumSamples(); nSample++)
-            {
-                double dSampleValue = buffer.getSample(nChannel, nSample);
-                float fNewSampleValue = pDither->dither(dSampleValue * dGain);
-                buffer.setSample(nChannel, nSample, fNewSampleValue);
-            }
+            float *fSamples = buffer.getWritePointer(nChannel);
+
+            // apply gain to whole block, then dither every channel
+            // with its own noise
+            FloatVectorOperations::multiply(fSamples, (float) dGain, nNumSamples);
+            pDither->ditherSamples(nChannel, fSamples, nNumSamples);
         }
     }
 
+    // changing the hop size neither allocates nor clears the ring
+    // buffer, so it is safe to do here
+    unsigned int uHopSize = getHopSize(pRingBufferInput->getSlidingWindowSize());
+
+    if (uHopSize != pRingBufferInput->getChunkSize())
+    {
+        pRingBufferInput->setChunkSize(uHopSize);
+    }
+
     pRingBufferInput->addSamples(buffer, 0, nNumSamples);
+}
+
+
+unsigned int TraKmeterAudioProcessor::getHopSize(const unsigned int uWindowSize)
+/*  Get number of samples between meter updates.
+
+    uWindowSize (unsigned integer): size of analysis window in
+    samples
+
+    return value: hop size in samples
+*/
+{
+    int nDivisor = getRealInteger(TraKmeterPluginParameters::selHopSize);
+
+    if (nDivisor < 1)
+    {
+        nDivisor = 1;
+    }
 
-    nSamplesInBuffer += nNumSamples;
-    nSamplesInBuffer %= TRAKMETER_BUFFER_SIZE;
+    return uWindowSize / nDivisor;
 }
 
 
 void TraKmeterAudioProcessor::processBufferChunk(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples)
 {
+    // meters may only be reset on the audio thread
+    if (nResetMeters.compareAndSetBool(0, 1))
+    {
+        pMeterBallistics->reset();
+    }
+
+    // meter ballistics may only be changed on the audio thread, too
+    int nNewTransientMode = nPendingTransientMode.exchange(-1);
+
+    if (nNewTransientMode >= 0)
+    {
+        pMeterBallistics->setTransientMode(nNewTransientMode != 0);
+    }
+
+    int nNewCrestFactor = nPendingCrestFactor.exchange(-1);
+
+    if (nNewCrestFactor >= 0)
+    {
+        pMeterBallistics->setCrestFactor(nNewCrestFactor);
+    }
+
     bool hasOpenEditor = (getActiveEditor() != nullptr);
 
     if (hasOpenEditor)
     {
-        unsigned int uPreDelay = uChunkSize / 2;
+        unsigned int uWindowSize = pRingBufferInput->getSlidingWindowSize();
 
-        // length of buffer chunk in fractional seconds
-        // (1024 samples / 44100 samples/s = 23.2 ms)
+        // length of hop in fractional seconds (256 samples / 44100
+        // samples/s = 5.8 ms, independent of sample rate)
         fProcessedSeconds = (float) uChunkSize / (float) getSampleRate();
 
         for (int nChannel = 0; nChannel < nNumInputChannels; nChannel++)
         {
-            // determine peak level for uChunkSize samples (use
-            // pre-delay)
-            fPeakLevels[nChannel] = pRingBufferInput->getMagnitude(nChannel, uChunkSize, uPreDelay);
-
-            // determine peak level for uChunkSize samples (use
-            // pre-delay)
-            fRmsLevels[nChannel] = pRingBufferInput->getRMSLevel(nChannel, uChunkSize, uPreDelay);
-
-            // determine overflows for uChunkSize samples (use
-            // pre-delay)
-            nOverflows[nChannel] = countOverflows(pRingBufferInput, nChannel, uChunkSize, uPreDelay);
-
-            // apply meter ballistics and store values so that the
-            // editor can access them
-            pMeterBallistics->updateChannel(nChannel, fProcessedSeconds, fPeakLevels[nChannel], fRmsLevels[nChannel], nOverflows[nChannel]);
+            // the ring buffer keeps running statistics, so reading
+            // peak level, RMS level and overflows for the whole
+            // window costs next to nothing (overflows are only
+            // counted for the samples of the current hop)
+            double dSumOfSquares;
+            pRingBufferInput->getSlidingWindow(nChannel, fPeakLevels[nChannel], dSumOfSquares, nOverflows[nChannel]);
+            fRmsLevels[nChannel] = (float) sqrt(dSumOfSquares / uWindowSize);
         }
 
-        // "UM" --> update meters
-        sendActionMessage("UM");
-    }
+        // apply meter ballistics to all channels at once and store
+        // values so that the editor can access them
+        pMeterBallistics->updateAllChannels(fProcessedSeconds, fPeakLevels, fRmsLevels, nOverflows);
 
-    AudioSampleBuffer TempAudioBuffer = AudioSampleBuffer(nNumInputChannels, uChunkSize);
-    pRingBufferInput->copyToBuffer(TempAudioBuffer, 0, uChunkSize, 0);
+        // hand the new meter readings over to the editor
+        pMeterBallistics->fillSnapshot(pSnapshotPublisher->getWriteBuffer());
+        pSnapshotPublisher->publish();
+    }
 }
 
 
-void TraKmeterAudioProcessor::startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
+void TraKmeterAudioProcessor::startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, const File &fileReport, bool bReportBinary)
 {
-    audioFilePlayer = new AudioFilePlayer(fileAudio, (int) getSampleRate(), pMeterBallistics, nCrestFactor);
-    audioFilePlayer->setReporters(nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel);
+    // set up player completely before the audio thread gets to see
+    // it
+    AudioFilePlayer *pNewPlayer = new AudioFilePlayer(fileAudio, (int) getSampleRate(), pMeterBallistics, nCrestFactor);
+    pNewPlayer->setReporters(nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel, fileReport, bReportBinary);
+
+    // publish player; storing the atomic pointer is a full memory
+    // barrier, so the audio thread only sees a completely set up
+    // player
+    deleteAudioFilePlayer();
+    audioFilePlayer = pNewPlayer;
 
     // reset all meters before we start the validation
-    pMeterBallistics->reset();
+    resetMeters();
 
-    // refresh editor; "V+" --> validation started
-    sendActionMessage("V+");
+    // refresh editor
+    pUpdateSignaller->signalValidation(true);
 }
 
 
 void TraKmeterAudioProcessor::stopValidation()
 {
-    delete audioFilePlayer;
-    audioFilePlayer = nullptr;
+    deleteAudioFilePlayer();
 
-    // refresh editor; "V-" --> validation stopped
-    sendActionMessage("V-");
+    // refresh editor
+    pUpdateSignaller->signalValidation(false);
 }
 
 
 bool TraKmeterAudioProcessor::isValidating()
 {
-    if (audioFilePlayer == nullptr)
+    AudioFilePlayer *pPlayer = audioFilePlayer.get();
+
+    if (pPlayer == nullptr)
     {
         return false;
     }
     else
     {
-        if (audioFilePlayer->isPlaying())
+        if (pPlayer->isPlaying())
         {
             return true;
         }
@@ -594,36 +780,40 @@ bool TraKmeterAudioProcessor::isValidating()
 }
 
 
-int TraKmeterAudioProcessor::countOverflows(AudioRingBuffer *ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay)
+void TraKmeterAudioProcessor::addUpdateListener(UpdateSignaller::Listener *listener)
 {
-    // initialise number of overflows in this buffer
-    int nOverflows = 0;
+    pUpdateSignaller->addListener(listener);
+}
 
-    // loop through samples of buffer
-    for (unsigned int uSample = 0; uSample < length; uSample++)
-    {
-        // get current sample value
-        float fSampleValue = ring_buffer->getSample(channel, uSample, pre_delay);
 
-        // in the 16-bit domain, full scale corresponds to an absolute
-        // integer value of 32'767 or 32'768, so we'll treat absolute
-        // levels of 32'767 and above as overflows; this corresponds
-        // to a floating-point level of 32'767 / 32'768 = 0.9999694
-        // (approx. -0.001 dBFS).
-        if ((fSampleValue < -0.9999f) || (fSampleValue > 0.9999f))
-        {
-            nOverflows++;
-        }
-    }
+void TraKmeterAudioProcessor::removeUpdateListener(UpdateSignaller::Listener *listener)
+{
+    pUpdateSignaller->removeListener(listener);
+}
 
-    // return number of overflows in this buffer
-    return nOverflows;
+
+void TraKmeterAudioProcessor::deliverUpdates()
+{
+    // only call this from the message thread; parameter changes are
+    // signalled without notifying the message thread, so the editor
+    // collects them on every frame
+    pUpdateSignaller->deliverSignals();
 }
 
 
-MeterBallistics *TraKmeterAudioProcessor::getLevels()
+const MeterSnapshot *TraKmeterAudioProcessor::getLevels()
 {
-    return pMeterBallistics;
+    // only call this from the editor; the returned snapshot remains
+    // valid until this function is called again
+    return pSnapshotPublisher->getLatestSnapshot();
+}
+
+
+void TraKmeterAudioProcessor::resetMeters()
+{
+    // meter ballistics are owned by the audio thread, so they will be
+    // reset on the next buffer chunk
+    nResetMeters = 1;
 }
 
 
@@ -639,13 +829,9 @@ void TraKmeterAudioProcessor::setTransientMode(const bool transient_mode)
     {
         bTransientMode = transient_mode;
 
-        if (pMeterBallistics)
-        {
-            delete pMeterBallistics;
-            pMeterBallistics = nullptr;
-
-            pMeterBallistics = new MeterBallistics(nNumInputChannels, nCrestFactor, true, false, bTransientMode);
-        }
+        // meter ballistics are owned by the audio thread, so they
+        // will be changed on the next buffer chunk
+        nPendingTransientMode = bTransientMode ? 1 : 0;
     }
 }
 
@@ -662,15 +848,22 @@ void TraKmeterAudioProcessor::setCrestFactor(const int crest_factor)
     {
         nCrestFactor = crest_factor;
 
-        if (pMeterBallistics)
-        {
-            pMeterBallistics->setCrestFactor(nCrestFactor);
-        }
+        // meter ballistics are owned by the audio thread, so they
+        // will be changed on the next buffer chunk
+        nPendingCrestFactor = nCrestFactor;
+
+        // hosts may call this from the audio thread, so keep the
+        // player from being deleted while it is in use
+        ++nPlayerInUse;
 
-        if (audioFilePlayer)
+        AudioFilePlayer *pPlayer = audioFilePlayer.get();
+
+        if (pPlayer)
         {
-            audioFilePlayer->setCrestFactor(nCrestFactor);
+            pPlayer->setCrestFactor(nCrestFactor);
         }
+
+        --nPlayerInUse;
     }
 }
 
@@ -681,10 +874,7 @@ AudioProcessorEditor *TraKmeterAudioProcessor::createEditor()
 {
     //  meter ballistics are not updated when the editor is closed, so
     //  reset them here
-    if (pMeterBallistics)
-    {
-        pMeterBallistics->reset();
-    }
+    resetMeters();
 
     if (nNumInputChannels > 0)
     {
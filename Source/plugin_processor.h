@@ -26,7 +26,11 @@
 #ifndef __TRAKMETER_PLUGINPROCESSOR_H__
 #define __TRAKMETER_PLUGINPROCESSOR_H__
 
-#define TRAKMETER_BUFFER_SIZE 1024
+// duration of the analysis window in milliseconds (corresponds to
+// 1024 samples at 44.1 kHz); window, pre-delay and hop size are
+// derived from it, so that the processing load does not depend on
+// the sample rate
+#define TRAKMETER_WINDOW_DURATION 23.22
 
 class TraKmeterAudioProcessor;
 class MeterBallistics;
@@ -36,11 +40,13 @@ class MeterBallistics;
 #include "audio_ring_buffer.h"
 #include "dither.h"
 #include "meter_ballistics.h"
+#include "meter_snapshot.h"
 #include "plugin_parameters.h"
+#include "update_signaller.h"
 
 
 //============================================================================
-class TraKmeterAudioProcessor  : public AudioProcessor, public ActionBroadcaster
+class TraKmeterAudioProcessor  : public AudioProcessor, public AudioRingBufferCallback
 {
 public:
     //==========================================================================
@@ -54,10 +60,14 @@ public:
 
     void processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages);
 
-    void startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    void startValidation(File fileAudio, int nSelectedChannel, bool bReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel, const File &fileReport, bool bReportBinary);
     void stopValidation();
     bool isValidating();
 
+    void addUpdateListener(UpdateSignaller::Listener *listener);
+    void removeUpdateListener(UpdateSignaller::Listener *listener);
+    void deliverUpdates();
+
     //==========================================================================
     AudioProcessorEditor *createEditor();
     bool hasEditor() const;
@@ -101,7 +111,8 @@ public:
     bool silenceInProducesSilenceOut() const;
     double getTailLengthSeconds() const;
 
-    MeterBallistics *getLevels();
+    const MeterSnapshot *getLevels();
+    void resetMeters();
     void processBufferChunk(AudioSampleBuffer &buffer, const unsigned int uChunkSize, const unsigned int uBufferPosition, const unsigned int uProcessedSamples);
 
     bool getTransientMode();
@@ -130,10 +141,24 @@ public:
 private:
     JUCE_LEAK_DETECTOR(TraKmeterAudioProcessor);
 
-    AudioFilePlayer *audioFilePlayer;
+    unsigned int getHopSize(const unsigned int uWindowSize);
+    void freeMeterState();
+    void deleteAudioFilePlayer();
+
+    // published by the message thread, used by the audio thread
+    // ("nPlayerInUse" counts the threads using the player)
+    Atomic<AudioFilePlayer *> audioFilePlayer;
+    Atomic<int> nPlayerInUse;
     AudioRingBuffer *pRingBufferInput;
 
     MeterBallistics *pMeterBallistics;
+    MeterSnapshotPublisher *pSnapshotPublisher;
+    Atomic<int> nResetMeters;
+    Atomic<int> nPendingTransientMode;
+    Atomic<int> nPendingCrestFactor;
+
+    UpdateSignaller *pUpdateSignaller;
+
     TraKmeterPluginParameters *pPluginParameters;
 
     Dither *pDither;
@@ -141,7 +166,6 @@ private:
     int nNumInputChannels;
     bool bSampleRateIsValid;
 
-    int nSamplesInBuffer;
     float fProcessedSeconds;
 
     bool bTransientMode;
@@ -153,7 +177,9 @@ private:
 
     int *nOverflows;
 
-    int countOverflows(AudioRingBuffer *ring_buffer, const unsigned int channel, const unsigned int length, const unsigned int pre_delay);
+    // backs "fPeakLevels", "fRmsLevels" and "nOverflows"
+    HeapBlock<char> pChannelMemory;
+    int nChannelCapacity;
 };
 
 AudioProcessor *JUCE_CALLTYPE createPluginFilter();
@@ -0,0 +1,505 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "realtime_audit.h"
+
+#ifdef TRAKMETER_REALTIME_AUDIT
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if JUCE_LINUX
+extern "C"
+{
+    void *__libc_malloc(size_t uSize);
+    void *__libc_calloc(size_t uNumber, size_t uSize);
+    void *__libc_realloc(void *pMemory, size_t uSize);
+    void __libc_free(void *pMemory);
+}
+#endif
+
+#if JUCE_MSVC
+#define REALTIME_AUDIT_THREAD_LOCAL __declspec(thread)
+#else
+#define REALTIME_AUDIT_THREAD_LOCAL __thread
+#endif
+
+
+// everything below is called from within the intercepted functions,
+// so it must neither allocate nor lock
+namespace
+{
+    const int nMaximumRecords = 64;
+    const int nMaximumFrames = 32;
+
+    struct ViolationRecord
+    {
+        int nType;
+        const char *strFunction;
+        void *pFrames[nMaximumFrames];
+        int nNumberOfFrames;
+    };
+
+    const char *strViolationTypes[RealtimeAudit::nNumViolationTypes] =
+    {
+        "allocation",
+        "lock",
+        "system call"
+    };
+
+    ViolationRecord violationRecords[nMaximumRecords];
+    Atomic<int> nNumberOfRecords;
+    Atomic<int> nViolationCounts[RealtimeAudit::nNumViolationTypes];
+
+    // nesting depth of audio thread scopes on the current thread
+    REALTIME_AUDIT_THREAD_LOCAL int nAudioThreadDepth = 0;
+
+    // guards against recording violations caused by the audit itself
+    REALTIME_AUDIT_THREAD_LOCAL bool bInsideAudit = false;
+
+#if JUCE_LINUX
+
+    // the first call of backtrace() loads libgcc and thus allocates;
+    // get this out of the way before any thread is marked
+    int warmUpBacktrace()
+    {
+        void *pFrames[1];
+        return backtrace(pFrames, 1);
+    }
+
+    int nBacktraceWarmUp = warmUpBacktrace();
+
+#endif
+
+    // "operator new" has already been recorded, so bypass the
+    // intercepted malloc() and free()
+    void *allocateMemory(std::size_t uSize)
+    {
+        if (uSize == 0)
+        {
+            uSize = 1;
+        }
+
+#if JUCE_LINUX
+        return __libc_malloc(uSize);
+#else
+        return std::malloc(uSize);
+#endif
+    }
+
+    void freeMemory(void *pMemory)
+    {
+#if JUCE_LINUX
+        __libc_free(pMemory);
+#else
+        std::free(pMemory);
+#endif
+    }
+}
+
+
+RealtimeAudit::ScopedAudioThread::ScopedAudioThread()
+{
+    ++nAudioThreadDepth;
+}
+
+
+RealtimeAudit::ScopedAudioThread::~ScopedAudioThread()
+{
+    --nAudioThreadDepth;
+}
+
+
+bool RealtimeAudit::isAudioThread()
+/*  Check whether the current thread is marked as audio thread.
+
+    return value: true if the current thread is inside an audio thread
+    scope, false otherwise
+*/
+{
+    return nAudioThreadDepth > 0;
+}
+
+
+void RealtimeAudit::registerViolation(int nType, const char *strFunction)
+/*  Record a call of a function that is not real-time safe.  Calls
+    from threads other than the audio thread are ignored.
+
+    nType (integer): type of violation (see ViolationTypes)
+
+    strFunction (string literal): name of the offending function
+
+    return value: none
+*/
+{
+    if ((nAudioThreadDepth <= 0) || bInsideAudit)
+    {
+        return;
+    }
+
+    bInsideAudit = true;
+
+    ++nViolationCounts[nType];
+    int nRecord = ++nNumberOfRecords - 1;
+
+    // keep stack traces of the first violations only
+    if (nRecord < nMaximumRecords)
+    {
+        ViolationRecord &record = violationRecords[nRecord];
+
+        record.nType = nType;
+        record.strFunction = strFunction;
+
+#if JUCE_LINUX
+        record.nNumberOfFrames = backtrace(record.pFrames, nMaximumFrames);
+#else
+        record.nNumberOfFrames = 0;
+#endif
+    }
+
+    bInsideAudit = false;
+}
+
+
+int RealtimeAudit::getNumberOfViolations()
+/*  Get total number of recorded violations.
+
+    return value: number of violations
+*/
+{
+    int nSum = 0;
+
+    for (int nType = 0; nType < nNumViolationTypes; ++nType)
+    {
+        nSum += nViolationCounts[nType].get();
+    }
+
+    return nSum;
+}
+
+
+int RealtimeAudit::getNumberOfViolations(int nType)
+/*  Get number of recorded violations of a given type.
+
+    nType (integer): type of violation (see ViolationTypes)
+
+    return value: number of violations
+*/
+{
+    return nViolationCounts[nType].get();
+}
+
+
+void RealtimeAudit::printReport()
+/*  Print summary and recorded stack traces of all violations to
+    stderr.  Must not be called from the audio thread.
+
+    return value: none
+*/
+{
+    int nNumberOfViolations = getNumberOfViolations();
+
+    fprintf(stderr, "\nReal-time audit: %d violation(s) on the audio thread\n", nNumberOfViolations);
+
+    for (int nType = 0; nType < nNumViolationTypes; ++nType)
+    {
+        fprintf(stderr, "  %-12s %d\n", strViolationTypes[nType], getNumberOfViolations(nType));
+    }
+
+    int nNumberOfRecords_ = jmin(nNumberOfRecords.get(), nMaximumRecords);
+
+    for (int nRecord = 0; nRecord < nNumberOfRecords_; ++nRecord)
+    {
+        const ViolationRecord &record = violationRecords[nRecord];
+
+        fprintf(stderr, "\n#%d: %s (%s)\n", nRecord + 1, record.strFunction, strViolationTypes[record.nType]);
+        fflush(stderr);
+
+#if JUCE_LINUX
+        backtrace_symbols_fd(record.pFrames, record.nNumberOfFrames, STDERR_FILENO);
+#endif
+    }
+
+    if (nNumberOfViolations > nMaximumRecords)
+    {
+        fprintf(stderr, "\n(stack traces of %d further violations were dropped)\n", nNumberOfViolations - nMaximumRecords);
+    }
+
+    fprintf(stderr, "\n");
+}
+
+
+//==============================================================================
+// replacements for the global allocation functions
+
+void *operator new(std::size_t uSize)
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator new");
+    void *pMemory = allocateMemory(uSize);
+
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pMemory;
+}
+
+
+void *operator new[](std::size_t uSize)
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator new[]");
+    void *pMemory = allocateMemory(uSize);
+
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pMemory;
+}
+
+
+void *operator new(std::size_t uSize, const std::nothrow_t &) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator new");
+    return allocateMemory(uSize);
+}
+
+
+void *operator new[](std::size_t uSize, const std::nothrow_t &) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator new[]");
+    return allocateMemory(uSize);
+}
+
+
+void operator delete(void *pMemory) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator delete");
+    freeMemory(pMemory);
+}
+
+
+void operator delete[](void *pMemory) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator delete[]");
+    freeMemory(pMemory);
+}
+
+
+void operator delete(void *pMemory, const std::nothrow_t &) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator delete");
+    freeMemory(pMemory);
+}
+
+
+void operator delete[](void *pMemory, const std::nothrow_t &) throw()
+{
+    RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "operator delete[]");
+    freeMemory(pMemory);
+}
+
+
+#if JUCE_LINUX
+
+//==============================================================================
+// interposed C library functions (glibc); the real functions are
+// looked up lazily without a guarded static, as guard variables may
+// lock a mutex themselves
+
+extern "C"
+{
+
+    void *malloc(size_t uSize)
+    {
+        RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "malloc");
+        return __libc_malloc(uSize);
+    }
+
+
+    void *calloc(size_t uNumber, size_t uSize)
+    {
+        RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "calloc");
+        return __libc_calloc(uNumber, uSize);
+    }
+
+
+    void *realloc(void *pMemory, size_t uSize)
+    {
+        RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "realloc");
+        return __libc_realloc(pMemory, uSize);
+    }
+
+
+    void free(void *pMemory)
+    {
+        RealtimeAudit::registerViolation(RealtimeAudit::violationAllocation, "free");
+        __libc_free(pMemory);
+    }
+
+
+    int pthread_mutex_lock(pthread_mutex_t *pMutex)
+    {
+        typedef int (*Function)(pthread_mutex_t *);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationLock, "pthread_mutex_lock");
+        return realFunction(pMutex);
+    }
+
+
+    ssize_t read(int nFile, void *pBuffer, size_t uCount)
+    {
+        typedef ssize_t (*Function)(int, void *, size_t);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "read");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "read");
+        return realFunction(nFile, pBuffer, uCount);
+    }
+
+
+    ssize_t write(int nFile, const void *pBuffer, size_t uCount)
+    {
+        typedef ssize_t (*Function)(int, const void *, size_t);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "write");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "write");
+        return realFunction(nFile, pBuffer, uCount);
+    }
+
+
+    size_t fwrite(const void *pBuffer, size_t uSize, size_t uCount, FILE *pFile)
+    {
+        typedef size_t (*Function)(const void *, size_t, size_t, FILE *);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "fwrite");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "fwrite");
+        return realFunction(pBuffer, uSize, uCount, pFile);
+    }
+
+
+    int open(const char *strPath, int nFlags, ...)
+    {
+        typedef int (*Function)(const char *, int, ...);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "open");
+        }
+
+        // the mode argument is only passed when a file is created
+        // (reading it otherwise is undefined behaviour)
+        mode_t nMode = 0;
+        bool bNeedsMode = (nFlags & O_CREAT) != 0;
+
+#ifdef O_TMPFILE
+        bNeedsMode = bNeedsMode || ((nFlags & O_TMPFILE) == O_TMPFILE);
+#endif
+
+        if (bNeedsMode)
+        {
+            va_list arguments;
+            va_start(arguments, nFlags);
+            nMode = (mode_t) va_arg(arguments, int);
+            va_end(arguments);
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "open");
+        return realFunction(strPath, nFlags, nMode);
+    }
+
+
+    int nanosleep(const struct timespec *pRequested, struct timespec *pRemaining)
+    {
+        typedef int (*Function)(const struct timespec *, struct timespec *);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "nanosleep");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "nanosleep");
+        return realFunction(pRequested, pRemaining);
+    }
+
+
+    int usleep(useconds_t uMicroseconds)
+    {
+        typedef int (*Function)(useconds_t);
+        static Function realFunction = nullptr;
+
+        if (realFunction == nullptr)
+        {
+            realFunction = (Function) dlsym(RTLD_NEXT, "usleep");
+        }
+
+        RealtimeAudit::registerViolation(RealtimeAudit::violationSystemCall, "usleep");
+        return realFunction(uMicroseconds);
+    }
+}
+
+#endif  // JUCE_LINUX
+
+#endif  // TRAKMETER_REALTIME_AUDIT
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,93 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __REALTIME_AUDIT_H__
+#define __REALTIME_AUDIT_H__
+
+#include "JuceHeader.h"
+
+
+#ifdef TRAKMETER_REALTIME_AUDIT
+
+//==============================================================================
+/**
+   Debug helper that checks the audio thread for real-time safety.
+   While a thread is marked as audio thread, every call of "operator
+   new", malloc() and friends, pthread_mutex_lock() and blocking
+   system calls (read, write, open, sleep) is recorded as violation,
+   together with a stack trace.
+
+   This is only compiled when TRAKMETER_REALTIME_AUDIT is defined
+   (see "premake4.lua").  The C library functions are intercepted on
+   GNU/Linux only, and interception is only reliable in executables
+   (stand-alone application), since shared libraries cannot replace
+   functions for the host.  "trakmeter_benchmark --audit" (or "make
+   audit") drives the audio callback and fails on any violation.
+*/
+class RealtimeAudit
+{
+public:
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+    };
+
+    enum ViolationTypes
+    {
+        violationAllocation = 0,
+        violationLock,
+        violationSystemCall,
+
+        nNumViolationTypes,
+    };
+
+    static bool isAudioThread();
+    static void registerViolation(int nType, const char *strFunction);
+
+    static int getNumberOfViolations();
+    static int getNumberOfViolations(int nType);
+
+    static void printReport();
+};
+
+
+// mark the enclosing scope as running on the audio thread
+#define TRAKMETER_AUDIO_THREAD_SCOPE RealtimeAudit::ScopedAudioThread realtimeAuditScope
+
+#else
+
+#define TRAKMETER_AUDIO_THREAD_SCOPE
+
+#endif  // TRAKMETER_REALTIME_AUDIT
+
+
+#endif  // __REALTIME_AUDIT_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,301 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "regression_suite.h"
+
+
+int RegressionSuite::run(const File &validationDirectory, bool bUpdateReferences, float fTolerance)
+/*  Run all test cases.  Golden references are stored in the
+    sub-directory "golden" of the validation directory.
+
+    validationDirectory (File): directory containing the validation
+    files (FLAC)
+
+    bUpdateReferences (Boolean): overwrite golden references with the
+    current readings instead of comparing
+
+    fTolerance (float): maximum difference of readings in decibel;
+    zero checks for bit-exact readings
+
+    return value (integer): exit code
+*/
+{
+    Array<File> childFiles;
+    validationDirectory.findChildFiles(childFiles, File::findFiles, false, "*.flac");
+
+    StringArray strFileNames;
+
+    for (int nChild = 0; nChild < childFiles.size(); nChild++)
+    {
+        strFileNames.add(childFiles[nChild].getFullPathName());
+    }
+
+    strFileNames.sort(true);
+
+    if (strFileNames.size() < 1)
+    {
+        fprintf(stderr, "ERROR: no validation files found in \"%s\"\n", validationDirectory.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    File goldenDirectory = validationDirectory.getChildFile("golden");
+
+    int nTestCases = 0;
+    int nFailures = 0;
+
+    // the logarithm test has no golden reference
+    if (!bUpdateReferences)
+    {
+        nTestCases++;
+
+        if (!runLogarithmTest())
+        {
+            nFailures++;
+        }
+    }
+
+    for (int nFile = 0; nFile < strFileNames.size(); nFile++)
+    {
+        File audioFile(strFileNames[nFile]);
+
+        for (int nCrestFactor = 0; nCrestFactor <= 20; nCrestFactor += 20)
+        {
+            for (int nMode = 0; nMode < 2; nMode++)
+            {
+                bool bTransientMode = (nMode == 0);
+                String strReferenceName = audioFile.getFileNameWithoutExtension() + (bTransientMode ? "_transient_" : "_averaging_") + String(nCrestFactor) + "dB.txt";
+
+                nTestCases++;
+
+                if (!runTestCase(audioFile, goldenDirectory.getChildFile(strReferenceName), nCrestFactor, bTransientMode, bUpdateReferences, fTolerance))
+                {
+                    nFailures++;
+                }
+            }
+        }
+    }
+
+    printf("\n%d of %d test case(s) %s.\n", nTestCases - nFailures, nTestCases, bUpdateReferences ? "updated" : "passed");
+    fflush(stdout);
+
+    return (nFailures == 0) ? 0 : 1;
+}
+
+
+bool RegressionSuite::runTestCase(const File &audioFile, const File &fileReference, int nCrestFactor, bool bTransientMode, bool bUpdateReference, float fTolerance)
+/*  Analyse a validation file and compare its readings with (or store
+    them as) golden reference.
+
+    return value (Boolean): true if the test case passed
+*/
+{
+    String strTestCase = fileReference.getFileNameWithoutExtension();
+    GoldenReference goldenReference;
+
+    if (!bUpdateReference && !goldenReference.loadFromFile(fileReference))
+    {
+        printf("MISSING  %s (create with --update-golden)\n", strTestCase.toRawUTF8());
+        fflush(stdout);
+
+        return false;
+    }
+
+    // measure at the checkpoints of the golden reference
+    GoldenReference measuredReadings;
+    measuredReadings.copyCheckpointsFrom(goldenReference);
+
+    // the meter is reported in the golden reference only, so discard
+    // the analyser's messages
+    MemoryOutputStream messageStream;
+
+    AudioFileAnalyser analyser(nCrestFactor, bTransientMode, nHopDivisor, nBlockSize, true);
+    analyser.setReporters(-1, false, false, false);
+    analyser.setCheckpoints(&measuredReadings);
+
+    if (!analyser.analyseFile(audioFile, &messageStream, &messageStream))
+    {
+        printf("ERROR    %s (could not open \"%s\")\n", strTestCase.toRawUTF8(), audioFile.getFullPathName().toRawUTF8());
+        fflush(stdout);
+
+        return false;
+    }
+
+    if (bUpdateReference)
+    {
+        String strDescription = audioFile.getFileName() + ", crest factor " + String(nCrestFactor) + " dB, " + (bTransientMode ? "transient" : "averaging") + " mode";
+
+        if (!measuredReadings.saveToFile(fileReference, strDescription))
+        {
+            printf("ERROR    %s (could not write \"%s\")\n", strTestCase.toRawUTF8(), fileReference.getFullPathName().toRawUTF8());
+            fflush(stdout);
+
+            return false;
+        }
+
+        printf("UPDATED  %s (%d checkpoints)\n", strTestCase.toRawUTF8(), measuredReadings.getNumberOfCheckpoints());
+        fflush(stdout);
+
+        return true;
+    }
+
+    StringArray strMismatches;
+    int nMismatches = measuredReadings.compareWith(goldenReference, fTolerance, strMismatches);
+
+    if (nMismatches == 0)
+    {
+        printf("PASS     %s\n", strTestCase.toRawUTF8());
+        fflush(stdout);
+
+        return true;
+    }
+
+    printf("FAIL     %s (%d mismatch(es))\n", strTestCase.toRawUTF8(), nMismatches);
+
+    for (int nMismatch = 0; nMismatch < jmin(strMismatches.size(), (int) nMaximumMismatches); nMismatch++)
+    {
+        printf("           %s\n", strMismatches[nMismatch].toRawUTF8());
+    }
+
+    fflush(stdout);
+
+    return false;
+}
+
+
+bool RegressionSuite::runLogarithmTest()
+/*  Convert every level between the meter minimum and +20 dB with
+    "MeterBallistics::levels2decibels" and compare the result with a
+    double-precision reference.  Also make sure that the displayed
+    meter segments do not change compared to "level2decibel" (log10f):
+    segment thresholds lie on a grid of 0.1 dB, and no level may end
+    up on the other side of a threshold.  Both crest factors are
+    checked, as they shift the displayed levels.
+
+    return value (Boolean): true if the test case passed
+*/
+{
+    String strTestCase = "fast_logarithm";
+
+    // documented error bound of "levels2decibels"
+    const double dMaximumError = 0.00001;
+
+    float fMinimumDecibel = MeterBallistics::getMeterMinimumDecibel();
+    float fMinimumLevel = MeterBallistics::decibel2level(fMinimumDecibel);
+    float fMaximumLevel = MeterBallistics::decibel2level(20.0f);
+
+    // the bit patterns of positive floats increase with their value,
+    // so every level in the range can be visited by counting
+    uint32 uFirstLevel;
+    uint32 uLastLevel;
+
+    memcpy(&uFirstLevel, &fMinimumLevel, sizeof(uint32));
+    memcpy(&uLastLevel, &fMaximumLevel, sizeof(uint32));
+
+    HeapBlock<float> fLevels(nLogarithmBatchSize);
+    HeapBlock<float> fDecibels(nLogarithmBatchSize);
+
+    double dWorstError = 0.0;
+    int64 nLevelsChecked = 0;
+    int64 nLevelsOutOfBounds = 0;
+    int64 nSegmentsChanged = 0;
+
+    uint32 uLevel = uFirstLevel;
+
+    while (uLevel <= uLastLevel)
+    {
+        int nLevels = 0;
+
+        while ((nLevels < nLogarithmBatchSize) && (uLevel <= uLastLevel))
+        {
+            memcpy(&fLevels[nLevels], &uLevel, sizeof(float));
+
+            nLevels++;
+            uLevel++;
+        }
+
+        MeterBallistics::levels2decibels(fLevels, fDecibels, nLevels);
+
+        for (int nLevel = 0; nLevel < nLevels; nLevel++)
+        {
+            double dExactDecibels = 20.0 * log10((double) fLevels[nLevel]);
+
+            // levels below the meter minimum are clamped
+            if (dExactDecibels < fMinimumDecibel)
+            {
+                continue;
+            }
+
+            double dError = fabs(fDecibels[nLevel] - dExactDecibels);
+            nLevelsChecked++;
+
+            if (dError > dWorstError)
+            {
+                dWorstError = dError;
+            }
+
+            if (dError > dMaximumError)
+            {
+                nLevelsOutOfBounds++;
+            }
+
+            float fReferenceDecibels = MeterBallistics::level2decibel(fLevels[nLevel]);
+
+            for (int nCrestFactor = 0; nCrestFactor <= 20; nCrestFactor += 20)
+            {
+                float fDisplayed = fDecibels[nLevel] + nCrestFactor;
+                float fReferenceDisplayed = fReferenceDecibels + nCrestFactor;
+
+                // both conversions differ by far less than the grid,
+                // so only the threshold closest to the reference can
+                // lie between them
+                float fThreshold = roundToInt(fReferenceDisplayed * 10.0f) * 0.1f;
+
+                if ((fDisplayed > fThreshold) != (fReferenceDisplayed > fThreshold))
+                {
+                    nSegmentsChanged++;
+                }
+            }
+        }
+    }
+
+    bool bPassed = (nLevelsOutOfBounds == 0) && (nSegmentsChanged == 0);
+
+    printf("%s %s (%lld levels, maximum error %.2g dB)\n", bPassed ? "PASS    " : "FAIL    ", strTestCase.toRawUTF8(), nLevelsChecked, dWorstError);
+
+    if (!bPassed)
+    {
+        printf("           %lld level(s) exceed the error bound of %.2g dB\n", nLevelsOutOfBounds, dMaximumError);
+        printf("           %lld segment(s) changed\n", nSegmentsChanged);
+    }
+
+    fflush(stdout);
+
+    return bPassed;
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,68 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __REGRESSION_SUITE_H__
+#define __REGRESSION_SUITE_H__
+
+#include "JuceHeader.h"
+#include "audio_file_analyser.h"
+#include "golden_reference.h"
+
+
+//==============================================================================
+/**
+   Runs the validation files through the metering pipeline in
+   transient and averaging mode with both crest factors and compares
+   the meter readings with stored golden references.  Also checks the
+   error of the fast logarithm used by the meter ballistics.
+*/
+class RegressionSuite
+{
+public:
+    static int run(const File &validationDirectory, bool bUpdateReferences, float fTolerance);
+
+private:
+    JUCE_LEAK_DETECTOR(RegressionSuite);
+
+    // settings of the analyser (match the defaults of the plug-in)
+    static const int nHopDivisor = 4;
+    static const int nBlockSize = 512;
+
+    // maximum number of mismatches printed per test case
+    static const int nMaximumMismatches = 10;
+
+    // number of levels converted at once by the logarithm test
+    static const int nLogarithmBatchSize = 4096;
+
+    static bool runTestCase(const File &audioFile, const File &fileReference, int nCrestFactor, bool bTransientMode, bool bUpdateReference, float fTolerance);
+    static bool runLogarithmTest();
+};
+
+#endif   // __REGRESSION_SUITE_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,319 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "report_writer.h"
+
+
+ReportWriter::ReportWriter(const String &report_name, int number_of_channels, float sample_rate, int crest_factor) : Thread("Report writer")
+/*  Constructor.
+
+    report_name (String): name that prefixes all messages
+
+    number_of_channels (integer): number of audio channels
+
+    sample_rate (float): sample rate (used for time codes)
+
+    crest_factor (integer): meter's crest factor in decibel
+
+    return value: none
+*/
+{
+    nNumberOfChannels = number_of_channels;
+    fSampleRate = sample_rate;
+    nCrestFactor = crest_factor;
+    nWrittenCrestFactor = crest_factor;
+
+    nReportsEnabled = 0;
+    bBinary = false;
+    nDroppedRecords = 0;
+
+    pRecordFifo = new AbstractFifo(nNumberOfRecords);
+    nRecordPositions = new int64[nNumberOfRecords];
+    nRecordCrestFactors = new int[nNumberOfRecords];
+    fRecordAverageLevels = new float[nNumberOfRecords * nNumberOfChannels];
+    fRecordPeakLevels = new float[nNumberOfRecords * nNumberOfChannels];
+
+    pMeterReporter = new MeterReporter(report_name, nNumberOfChannels, fSampleRate, crest_factor);
+    pFileStream = nullptr;
+}
+
+
+ReportWriter::~ReportWriter()
+{
+    // write remaining records before closing the file
+    stopThread(5000);
+
+    delete pFileStream;
+    pFileStream = nullptr;
+
+    delete pMeterReporter;
+    pMeterReporter = nullptr;
+
+    delete pRecordFifo;
+    pRecordFifo = nullptr;
+
+    delete [] nRecordPositions;
+    nRecordPositions = nullptr;
+
+    delete [] nRecordCrestFactors;
+    nRecordCrestFactors = nullptr;
+
+    delete [] fRecordAverageLevels;
+    fRecordAverageLevels = nullptr;
+
+    delete [] fRecordPeakLevels;
+    fRecordPeakLevels = nullptr;
+}
+
+
+void ReportWriter::setCrestFactor(int crest_factor)
+/*  Set crest factor of all following records.  The meter reporter
+    belongs to the writer thread, so the crest factor is queued with
+    every record and applied when the record is written.
+
+    crest_factor (integer): meter's crest factor in decibel
+
+    return value: none
+*/
+{
+    nCrestFactor = crest_factor;
+}
+
+
+void ReportWriter::setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel)
+/*  Select reports.  Must be called before the thread is started.
+
+    return value: none
+*/
+{
+    jassert(!isThreadRunning());
+
+    pMeterReporter->setReporters(nChannel, ReportCSV, bAverageMeterLevel, bPeakMeterLevel);
+    nReportsEnabled = pMeterReporter->isReporting() ? 1 : 0;
+}
+
+
+bool ReportWriter::setOutputFile(const File &fileReport, bool bBinary_)
+/*  Write reports to a file instead of the debug log.  Must be called
+    before the thread is started.
+
+    fileReport (File): report file (will be overwritten)
+
+    bBinary_ (Boolean): write binary records instead of text
+
+    return value (Boolean): true if the file could be created
+*/
+{
+    jassert(!isThreadRunning());
+
+    delete pFileStream;
+    pFileStream = nullptr;
+
+    fileReport.deleteFile();
+    pFileStream = fileReport.createOutputStream(nWriteBufferSize);
+
+    if (pFileStream == nullptr)
+    {
+        bBinary = false;
+        return false;
+    }
+
+    bBinary = bBinary_;
+
+    if (bBinary)
+    {
+        writeBinaryHeader();
+    }
+    else
+    {
+        pMeterReporter->setOutputStreams(pFileStream, nullptr);
+    }
+
+    return true;
+}
+
+
+bool ReportWriter::isReporting()
+{
+    return nReportsEnabled.get() != 0;
+}
+
+
+void ReportWriter::disableReports()
+{
+    nReportsEnabled = 0;
+}
+
+
+void ReportWriter::pushReadings(int64 nPosition, MeterBallistics *pMeterBallistics)
+/*  Queue current meter readings.  Safe to call from the audio thread:
+    neither allocates, locks nor waits.
+
+    nPosition (64-bit integer): current position in samples
+
+    pMeterBallistics (pointer to MeterBallistics): meter readings
+
+    return value: none
+*/
+{
+    if (!isReporting())
+    {
+        return;
+    }
+
+    int nStart1, nSize1, nStart2, nSize2;
+    pRecordFifo->prepareToWrite(1, nStart1, nSize1, nStart2, nSize2);
+
+    // writer has fallen behind, so drop record
+    if (nSize1 < 1)
+    {
+        ++nDroppedRecords;
+        return;
+    }
+
+    int nOffset = nStart1 * nNumberOfChannels;
+    nRecordPositions[nStart1] = nPosition;
+    nRecordCrestFactors[nStart1] = nCrestFactor.get();
+
+    for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+    {
+        fRecordAverageLevels[nOffset + nChannel] = pMeterBallistics->getAverageMeterLevel(nChannel);
+        fRecordPeakLevels[nOffset + nChannel] = pMeterBallistics->getPeakMeterLevel(nChannel);
+    }
+
+    // do not wake up the writer thread, as signalling its event locks
+    // a mutex; the writer polls the ring instead
+    pRecordFifo->finishedWrite(1);
+}
+
+
+int ReportWriter::getNumberOfDroppedRecords()
+/*  Get number of records that were dropped because the ring was
+    full.
+
+    return value (integer): number of dropped records
+*/
+{
+    return nDroppedRecords.get();
+}
+
+
+void ReportWriter::run()
+{
+    while (true)
+    {
+        // check before writing, so that no records are lost when
+        // the thread is stopped
+        bool bShouldExit = threadShouldExit();
+
+        writeRecords();
+
+        if (bShouldExit)
+        {
+            break;
+        }
+
+        wait(nWaitTimeout);
+    }
+
+    if (pFileStream)
+    {
+        pFileStream->flush();
+    }
+}
+
+
+void ReportWriter::writeRecords()
+/*  Write all queued records.
+
+    return value: none
+*/
+{
+    int nStart1, nSize1, nStart2, nSize2;
+    pRecordFifo->prepareToRead(pRecordFifo->getNumReady(), nStart1, nSize1, nStart2, nSize2);
+
+    for (int nBlock = 0; nBlock < 2; nBlock++)
+    {
+        int nStart = (nBlock == 0) ? nStart1 : nStart2;
+        int nSize = (nBlock == 0) ? nSize1 : nSize2;
+
+        for (int nRecord = nStart; nRecord < (nStart + nSize); nRecord++)
+        {
+            int nOffset = nRecord * nNumberOfChannels;
+
+            if (nRecordCrestFactors[nRecord] != nWrittenCrestFactor)
+            {
+                nWrittenCrestFactor = nRecordCrestFactors[nRecord];
+
+                if (bBinary)
+                {
+                    pFileStream->writeInt64(nCrestFactorMarker);
+                    pFileStream->writeInt(nWrittenCrestFactor);
+                }
+                else
+                {
+                    pMeterReporter->setCrestFactor(nWrittenCrestFactor);
+                }
+            }
+
+            if (bBinary)
+            {
+                pFileStream->writeInt64(nRecordPositions[nRecord]);
+
+                for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+                {
+                    pFileStream->writeFloat(fRecordAverageLevels[nOffset + nChannel]);
+                }
+
+                for (int nChannel = 0; nChannel < nNumberOfChannels; nChannel++)
+                {
+                    pFileStream->writeFloat(fRecordPeakLevels[nOffset + nChannel]);
+                }
+            }
+            else
+            {
+                pMeterReporter->setPosition(nRecordPositions[nRecord]);
+                pMeterReporter->outputReport(fRecordAverageLevels + nOffset, fRecordPeakLevels + nOffset);
+            }
+        }
+    }
+
+    pRecordFifo->finishedRead(nSize1 + nSize2);
+}
+
+
+void ReportWriter::writeBinaryHeader()
+{
+    pFileStream->write("TKMR", 4);
+    pFileStream->writeInt(nBinaryFormatVersion);
+    pFileStream->writeInt(nNumberOfChannels);
+    pFileStream->writeInt(nWrittenCrestFactor);
+    pFileStream->writeDouble(fSampleRate);
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
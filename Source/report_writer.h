@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __REPORT_WRITER_H__
+#define __REPORT_WRITER_H__
+
+class ReportWriter;
+
+#include "JuceHeader.h"
+#include "meter_ballistics.h"
+#include "meter_reporter.h"
+
+
+//==============================================================================
+/**
+   Writes validation reports without touching the audio thread's
+   timing.  The audio thread only copies meter readings into a
+   lock-free ring of fixed-size records (dropping records instead of
+   waiting when the ring is full).  A background thread polls the
+   ring and formats the records as plain text or CSV, or writes them
+   as compact binary records, to a file with large buffered writes
+   (or to the debug log).
+
+   The crest factor may be changed during validation.  It is queued
+   with every record, so that each record is reported with the crest
+   factor it was measured with.
+
+   Binary format (little-endian): header of magic "TKMR", format
+   version (int32), number of channels (int32), crest factor (int32)
+   and sample rate (float64), followed by records of position in
+   samples (int64), average meter levels and peak meter levels of all
+   channels (float32 each).  A position of -1 marks a change of crest
+   factor and is followed by the new crest factor (int32) instead of
+   meter levels.
+*/
+class ReportWriter : public Thread
+{
+public:
+    ReportWriter(const String &report_name, int number_of_channels, float sample_rate, int crest_factor);
+    ~ReportWriter();
+
+    void setCrestFactor(int crest_factor);
+    void setReporters(int nChannel, bool ReportCSV, bool bAverageMeterLevel, bool bPeakMeterLevel);
+    bool setOutputFile(const File &fileReport, bool bBinary);
+
+    bool isReporting();
+    void disableReports();
+
+    void pushReadings(int64 nPosition, MeterBallistics *pMeterBallistics);
+    int getNumberOfDroppedRecords();
+
+    void run();
+
+private:
+    JUCE_LEAK_DETECTOR(ReportWriter);
+
+    // number of records the ring can hold (about 6 seconds of
+    // reports with a block size of 512 samples at 44.1 kHz)
+    static const int nNumberOfRecords = 512;
+
+    // size of the file buffer in bytes
+    static const int nWriteBufferSize = 1048576;
+
+    // interval for polling the ring for new records in milliseconds
+    // (the ring holds far more records than arrive in this time)
+    static const int nWaitTimeout = 20;
+
+    static const int nBinaryFormatVersion = 2;
+
+    // position that marks a change of crest factor in binary output
+    static const int64 nCrestFactorMarker = -1;
+
+    int nNumberOfChannels;
+    float fSampleRate;
+
+    // written on the message thread, read on the audio thread
+    Atomic<int> nCrestFactor;
+
+    // crest factor of the last written record (writer thread only)
+    int nWrittenCrestFactor;
+
+    Atomic<int> nReportsEnabled;
+    bool bBinary;
+    Atomic<int> nDroppedRecords;
+
+    AbstractFifo *pRecordFifo;
+    int64 *nRecordPositions;
+    int *nRecordCrestFactors;
+    float *fRecordAverageLevels;
+    float *fRecordPeakLevels;
+
+    MeterReporter *pMeterReporter;
+    FileOutputStream *pFileStream;
+
+    void writeBinaryHeader();
+    void writeRecords();
+};
+
+#endif   // __REPORT_WRITER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -136,11 +136,33 @@ void SignalMeter::resized()
 }
 
 
-void SignalMeter::setLevels(MeterBallistics *pMeterBallistics)
+void SignalMeter::setCrestFactor(int CrestFactor)
+/*  Retarget thresholds and scale to a new crest factor in place
+    (without re-creating any components).
+
+    CrestFactor (integer): meter crest factor (0 or 20 dB)
+
+    return value: none
+*/
+{
+    nCrestFactor = CrestFactor;
+
+    // signals are detected at -60 dB FS and above (40 dB meter range)
+    int nThreshold = (-60 + nCrestFactor) * 10;
+    float fRange = 40.0f;
+
+    for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
+    {
+        PeakMeterSignals[nChannel]->setThresholds(nThreshold * 0.1f, fRange);
+    }
+}
+
+
+void SignalMeter::setLevels(const MeterSnapshot *pMeterSnapshot)
 {
     for (int nChannel = 0; nChannel < nInputChannels; nChannel++)
     {
-        PeakMeterSignals[nChannel]->setLevel(pMeterBallistics->getPeakMeterSignal(nChannel));
+        PeakMeterSignals[nChannel]->setLevel(pMeterSnapshot->getPeakMeterSignal(nChannel));
     }
 }
 
@@ -41,7 +41,8 @@ public:
     SignalMeter(const String &componentName, int PosX, int PosY, int width, int CrestFactor, int nNumChannels);
     ~SignalMeter();
 
-    void setLevels(MeterBallistics *pMeterBallistics);
+    void setCrestFactor(int CrestFactor);
+    void setLevels(const MeterSnapshot *pMeterSnapshot);
     void paint(Graphics &g);
     int getPreferredHeight();
     void resized();
@@ -50,6 +50,9 @@ void StandaloneApplication::initialise(const String &commandLineParameters)
     PropertiesFile *pPropertiesFile = new PropertiesFile(options);
     String strApplicationName = getApplicationName();
 
+    // redraw rate of the meters (such as 30 or 60 frames per second)
+    frameScheduler->setFrameRate(pPropertiesFile->getIntValue("frameRate", FrameScheduler::nDefaultFrameRate));
+
     filterWindow = new StandaloneFilterWindow(strApplicationName, Colours::black, pPropertiesFile, true);
 
     filterWindow->setTitleBarButtonsRequired(DocumentWindow::allButtons, false);
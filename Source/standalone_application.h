@@ -27,6 +27,7 @@
 #define __STANDALONE_APPLICATION_H__
 
 #include "JuceHeader.h"
+#include "frame_scheduler.h"
 #include "plugin_processor.h"
 #include "juce/modules/juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h"
 
@@ -46,6 +47,7 @@ private:
     JUCE_LEAK_DETECTOR(StandaloneApplication);
 
     StandaloneFilterWindow *filterWindow;
+    SharedResourcePointer<FrameScheduler> frameScheduler;
 };
 
 #endif   // __STANDALONE_APPLICATION_H__
@@ -25,7 +25,7 @@
 
 #include "trakmeter.h"
 
-TraKmeter::TraKmeter(const String &componentName, int posX, int posY, int nCrestFactor, int nNumChannels, int nSegmentHeight, int meter_type)
+TraKmeter::TraKmeter(const String &componentName, int posX, int posY, int CrestFactor, int nNumChannels, int segment_height, int meter_type)
 {
     setName(componentName);
 
@@ -33,44 +33,55 @@ TraKmeter::TraKmeter(const String &componentName, int posX, int posY, int nCrest
     setOpaque(false);
 
     nInputChannels = nNumChannels;
-    nMeterType = meter_type;
+    nCrestFactor = CrestFactor;
+    nSegmentHeight = segment_height;
 
     nPosX = posX;
     nPosY = posY;
     nWidth = 2 * TRAKMETER_LABEL_WIDTH + nInputChannels * (TRAKMETER_SEGMENT_WIDTH + 6) - 3;
     nHeight = 0;
 
+    nHeightSeparateMeters = 0;
+    nHeightCombinedMeter = 0;
+
     combined_meter = nullptr;
 
     peak_meter = nullptr;
     average_meter = nullptr;
     signal_meter = nullptr;
 
-    if (nMeterType == TraKmeterPluginParameters::selSeparateMeters)
-    {
-        peak_meter = new PeakMeter("Peak Meter", 4, 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight);
-        addAndMakeVisible(peak_meter);
+    // force creation of layout
+    nMeterType = -1;
+    setMeterType(meter_type);
+}
 
-        int nHeightPeakMeter = peak_meter->getPreferredHeight();
-        int nHeightSeparator = 29;
 
-        signal_meter = new SignalMeter("Signal Meter", 4, nHeightPeakMeter + (nHeightSeparator - 14) / 2 + 4, nWidth - 8, nCrestFactor, nInputChannels);
-        addAndMakeVisible(signal_meter);
+void TraKmeter::createSeparateMeters()
+{
+    peak_meter = new PeakMeter("Peak Meter", 4, 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight);
+    addChildComponent(peak_meter);
 
-        average_meter = new AverageMeter("Average Meter", 4, nHeightPeakMeter + nHeightSeparator + 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight);
-        addAndMakeVisible(average_meter);
+    int nHeightPeakMeter = peak_meter->getPreferredHeight();
+    int nHeightSeparator = 29;
 
-        int nHeightAverageMeter = average_meter->getPreferredHeight();
+    signal_meter = new SignalMeter("Signal Meter", 4, nHeightPeakMeter + (nHeightSeparator - 14) / 2 + 4, nWidth - 8, nCrestFactor, nInputChannels);
+    addChildComponent(signal_meter);
 
-        nHeight = nHeightPeakMeter + nHeightAverageMeter + nHeightSeparator + 8;
-    }
-    else
-    {
-        combined_meter = new CombinedMeter("Combined Meter", 4, 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight - 1);
-        addAndMakeVisible(combined_meter);
+    average_meter = new AverageMeter("Average Meter", 4, nHeightPeakMeter + nHeightSeparator + 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight);
+    addChildComponent(average_meter);
 
-        nHeight = combined_meter->getPreferredHeight() + 8;
-    }
+    int nHeightAverageMeter = average_meter->getPreferredHeight();
+
+    nHeightSeparateMeters = nHeightPeakMeter + nHeightAverageMeter + nHeightSeparator + 8;
+}
+
+
+void TraKmeter::createCombinedMeter()
+{
+    combined_meter = new CombinedMeter("Combined Meter", 4, 4, nWidth - 8, nCrestFactor, nInputChannels, nSegmentHeight - 1);
+    addChildComponent(combined_meter);
+
+    nHeightCombinedMeter = combined_meter->getPreferredHeight() + 8;
 }
 
 
@@ -122,17 +133,98 @@ void TraKmeter::resized()
 }
 
 
-void TraKmeter::setLevels(MeterBallistics *pMeterBallistics)
+void TraKmeter::setCrestFactor(int CrestFactor)
+/*  Retarget all meters to a new crest factor in place.  Both layouts
+    are updated (if they have been created), so that switching the
+    meter type later on is instant.
+
+    CrestFactor (integer): meter crest factor (0 or 20 dB)
+
+    return value: none
+*/
+{
+    if (CrestFactor == nCrestFactor)
+    {
+        return;
+    }
+
+    nCrestFactor = CrestFactor;
+
+    if (peak_meter)
+    {
+        peak_meter->setCrestFactor(nCrestFactor);
+        average_meter->setCrestFactor(nCrestFactor);
+        signal_meter->setCrestFactor(nCrestFactor);
+    }
+
+    if (combined_meter)
+    {
+        combined_meter->setCrestFactor(nCrestFactor);
+    }
+}
+
+
+void TraKmeter::setMeterType(int meter_type)
+/*  Show separate or combined meters.  Each layout is created when it
+    is first needed and kept afterwards, so switching back and forth
+    does not create any components.
+
+    meter_type (integer): meter type (see TraKmeterPluginParameters)
+
+    return value: none
+*/
+{
+    if (meter_type == nMeterType)
+    {
+        return;
+    }
+
+    nMeterType = meter_type;
+    bool bSeparateMeters = (nMeterType == TraKmeterPluginParameters::selSeparateMeters);
+
+    if (bSeparateMeters && (peak_meter == nullptr))
+    {
+        createSeparateMeters();
+    }
+    else if (!bSeparateMeters && (combined_meter == nullptr))
+    {
+        createCombinedMeter();
+    }
+
+    if (peak_meter)
+    {
+        peak_meter->setVisible(bSeparateMeters);
+        average_meter->setVisible(bSeparateMeters);
+        signal_meter->setVisible(bSeparateMeters);
+    }
+
+    if (combined_meter)
+    {
+        combined_meter->setVisible(!bSeparateMeters);
+    }
+
+    nHeight = bSeparateMeters ? nHeightSeparateMeters : nHeightCombinedMeter;
+
+    if (isVisible())
+    {
+        setBounds(nPosX, nPosY, nWidth, nHeight);
+    }
+
+    repaint();
+}
+
+
+void TraKmeter::setLevels(const MeterSnapshot *pMeterSnapshot)
 {
     if (nMeterType == TraKmeterPluginParameters::selSeparateMeters)
     {
-        peak_meter->setLevels(pMeterBallistics);
-        average_meter->setLevels(pMeterBallistics);
-        signal_meter->setLevels(pMeterBallistics);
+        peak_meter->setLevels(pMeterSnapshot);
+        average_meter->setLevels(pMeterSnapshot);
+        signal_meter->setLevels(pMeterSnapshot);
     }
     else
     {
-        combined_meter->setLevels(pMeterBallistics);
+        combined_meter->setLevels(pMeterSnapshot);
     }
 }
 
@@ -47,10 +47,12 @@ public:
     static const int TRAKMETER_LABEL_WIDTH = 38;
     static const int TRAKMETER_SEGMENT_WIDTH = 22;
 
-    TraKmeter(const String &componentName, int PosX, int PosY, int nCrestFactor, int nNumChannels, int nSegmentHeight, int meter_type);
+    TraKmeter(const String &componentName, int PosX, int PosY, int CrestFactor, int nNumChannels, int segment_height, int meter_type);
     ~TraKmeter();
 
-    void setLevels(MeterBallistics *pMeterBallistics);
+    void setCrestFactor(int CrestFactor);
+    void setMeterType(int meter_type);
+    void setLevels(const MeterSnapshot *pMeterSnapshot);
     void paint(Graphics &g);
     void resized();
     void visibilityChanged();
@@ -64,13 +66,21 @@ private:
     int nWidth;
 
     int nMeterType;
+    int nCrestFactor;
     int nInputChannels;
+    int nSegmentHeight;
+
+    int nHeightSeparateMeters;
+    int nHeightCombinedMeter;
 
     CombinedMeter *combined_meter;
 
     PeakMeter *peak_meter;
     AverageMeter *average_meter;
     SignalMeter *signal_meter;
+
+    void createSeparateMeters();
+    void createCombinedMeter();
 };
 
 
@@ -0,0 +1,133 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#include "update_signaller.h"
+
+
+UpdateSignaller::UpdateSignaller()
+{
+    nPendingSignals = 0;
+    nChangedParameters = 0;
+}
+
+
+UpdateSignaller::~UpdateSignaller()
+{
+    cancelPendingUpdate();
+}
+
+
+void UpdateSignaller::addListener(Listener *listener)
+{
+    // only call this from the message thread
+    listeners.add(listener);
+}
+
+
+void UpdateSignaller::removeListener(Listener *listener)
+{
+    // only call this from the message thread
+    listeners.remove(listener);
+}
+
+
+void UpdateSignaller::setBits(Atomic<uint32> &atomicMask, uint32 nBits)
+{
+    // atomically "OR" bits into mask
+    uint32 nOldMask = atomicMask.get();
+
+    while (!atomicMask.compareAndSetBool(nOldMask | nBits, nOldMask))
+    {
+        nOldMask = atomicMask.get();
+    }
+}
+
+
+void UpdateSignaller::signalParameterChange(int nIndex)
+{
+    // This method will be called on the audio thread, so it's
+    // absolutely time-critical. Don't use critical sections or
+    // anything GUI-related, or anything at all that may block in any
+    // way!  (Triggering an asynchronous update posts a message, which
+    // locks the message queue and may allocate memory, so changes are
+    // collected by "deliverSignals()" instead.)
+
+    jassert(nIndex >= 0);
+    jassert(nIndex < nMaximumParameters);
+
+    // shifting a signed 1 into the sign bit is undefined behaviour
+    setBits(nChangedParameters, 1u << nIndex);
+}
+
+
+void UpdateSignaller::signalValidation(bool bIsValidating)
+{
+    // only call this from the message thread
+    setBits(nPendingSignals, bIsValidating ? signalValidationStarted : signalValidationStopped);
+    triggerAsyncUpdate();
+}
+
+
+void UpdateSignaller::handleAsyncUpdate()
+{
+    deliverSignals();
+}
+
+
+void UpdateSignaller::deliverSignals()
+/*  Deliver all pending signals to the listeners.  Only call this from
+    the message thread.
+
+    return value: none
+*/
+{
+    // fetch and clear all signals that have been raised since the
+    // last call
+    uint32 nSignals = nPendingSignals.exchange(0);
+    uint32 nParameters = nChangedParameters.exchange(0);
+
+    for (int nIndex = 0; nIndex < nMaximumParameters; nIndex++)
+    {
+        if (nParameters & (1u << nIndex))
+        {
+            listeners.call(&Listener::parameterChanged, nIndex);
+        }
+    }
+
+    if (nSignals & signalValidationStarted)
+    {
+        listeners.call(&Listener::validationChanged, true);
+    }
+
+    if (nSignals & signalValidationStopped)
+    {
+        listeners.call(&Listener::validationChanged, false);
+    }
+}
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -0,0 +1,96 @@
+/* ----------------------------------------------------------------------------
+
+   traKmeter
+   =========
+   Loudness meter for correctly setting up tracking and mixing levels
+
+   Copyright (c) 2012-2015 Martin Zuther (http://www.mzuther.de/)
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+   Thank you for using free software!
+
+---------------------------------------------------------------------------- */
+
+#ifndef __UPDATE_SIGNALLER_H__
+#define __UPDATE_SIGNALLER_H__
+
+class UpdateSignaller;
+
+#include "JuceHeader.h"
+
+
+//==============================================================================
+/**
+   Notifies the editor of parameter changes and the state of
+   validation.  (Meter updates are pulled by the editor on every
+   frame; see FrameScheduler.)  Parameter changes may be signalled
+   from any thread (and especially from the audio thread) without
+   allocating memory or locking: they simply set bits in unsigned
+   atomic masks, which the editor collects on its next frame by
+   calling deliverSignals().  Validation is signalled from the
+   message thread only and additionally triggers an asynchronous
+   update, so that it is delivered even without an open editor.
+*/
+class UpdateSignaller : public AsyncUpdater
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        virtual void parameterChanged(int nIndex) = 0;
+        virtual void validationChanged(bool bValidationStarted) = 0;
+    };
+
+    UpdateSignaller();
+    ~UpdateSignaller();
+
+    void addListener(Listener *listener);
+    void removeListener(Listener *listener);
+
+    void signalParameterChange(int nIndex);
+    void signalValidation(bool bIsValidating);
+
+    void deliverSignals();
+    void handleAsyncUpdate();
+
+    // maximum number of parameters that can be signalled
+    static const int nMaximumParameters = 32;
+
+private:
+    JUCE_LEAK_DETECTOR(UpdateSignaller);
+
+    enum Signals
+    {
+        signalValidationStarted = 1,
+        signalValidationStopped = 2,
+    };
+
+    static void setBits(Atomic<uint32> &atomicMask, uint32 nBits);
+
+    Atomic<uint32> nPendingSignals;
+    Atomic<uint32> nChangedParameters;
+
+    ListenerList<Listener> listeners;
+};
+
+
+#endif  // __UPDATE_SIGNALLER_H__
+
+
+// Local Variables:
+// ispell-local-dictionary: "british"
+// End:
@@ -31,7 +31,7 @@ WindowValidation::WindowValidation(Component *pEditorWindow, TraKmeterAudioProce
     // create new window child
 {
     int nWidth = 170;
-    int nHeight = 190;
+    int nHeight = 230;
 
     pProcessor = processor;
     pProcessor->stopValidation();
@@ -113,6 +113,16 @@ WindowValidation::WindowValidation(Component *pEditorWindow, TraKmeterAudioProce
     ButtonDumpPeakMeterLevel->setToggleState(pProcessor->getBoolean(TraKmeterPluginParameters::selValidationPeakMeterLevel), dontSendNotification);
     contentComponent->addAndMakeVisible(ButtonDumpPeakMeterLevel);
 
+    ButtonDumpToFile = new ToggleButton("Write to file");
+    ButtonDumpToFile->setColour(ToggleButton::textColourId, Colours::black);
+    ButtonDumpToFile->setToggleState(pProcessor->getBoolean(TraKmeterPluginParameters::selValidationWriteToFile), dontSendNotification);
+    contentComponent->addAndMakeVisible(ButtonDumpToFile);
+
+    ButtonDumpBinary = new ToggleButton("Binary format");
+    ButtonDumpBinary->setColour(ToggleButton::textColourId, Colours::black);
+    ButtonDumpBinary->setToggleState(pProcessor->getBoolean(TraKmeterPluginParameters::selValidationBinaryFormat), dontSendNotification);
+    contentComponent->addAndMakeVisible(ButtonDumpBinary);
+
     // create and position a "validation" button which closes the
     // window and runs the selected audio file when clicked
     ButtonValidation = new TextButton("Validate");
@@ -159,6 +169,12 @@ WindowValidation::WindowValidation(Component *pEditorWindow, TraKmeterAudioProce
     nPositionY += 20;
     ButtonDumpCSV->setBounds(nPositionX + 1, nPositionY, 180, 20);
 
+    nPositionY += 20;
+    ButtonDumpToFile->setBounds(nPositionX + 1, nPositionY, 180, 20);
+
+    nPositionY += 20;
+    ButtonDumpBinary->setBounds(nPositionX + 1, nPositionY, 180, 20);
+
     nPositionY += 31;
     ButtonValidation->setBounds(18, nPositionY, 60, 20);
     ButtonCancel->setBounds(88, nPositionY, 60, 20);
@@ -203,8 +219,36 @@ void WindowValidation::buttonClicked(Button *button)
         bool bPeakMeterLevel = ButtonDumpPeakMeterLevel->getToggleState();
         pProcessor->setParameter(TraKmeterPluginParameters::selValidationPeakMeterLevel, bPeakMeterLevel ? 1.0f : 0.0f);
 
+        bool bReportToFile = ButtonDumpToFile->getToggleState();
+        pProcessor->setParameter(TraKmeterPluginParameters::selValidationWriteToFile, bReportToFile ? 1.0f : 0.0f);
+
+        bool bReportBinary = ButtonDumpBinary->getToggleState();
+        pProcessor->setParameter(TraKmeterPluginParameters::selValidationBinaryFormat, bReportBinary ? 1.0f : 0.0f);
+
+        // reports are written to the debug log by default
+        File fileReport = File::nonexistent;
+
+        if (bReportToFile)
+        {
+            String strExtension = bReportBinary ? "tkm" : (bReportCSV ? "csv" : "txt");
+            FileChooser browser("Save validation report", fileValidation.withFileExtension(strExtension), "*." + strExtension, true);
+
+            if (!browser.showDialog(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles | FileBrowserComponent::warnAboutOverwriting, nullptr))
+            {
+                // prevent closing of window
+                return;
+            }
+
+            fileReport = browser.getResult();
+        }
+        // binary reports cannot be sent to the debug log
+        else
+        {
+            bReportBinary = false;
+        }
+
         // validation file has already been initialised
-        pProcessor->startValidation(fileValidation, nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel);
+        pProcessor->startValidation(fileValidation, nSelectedChannel, bReportCSV, bAverageMeterLevel, bPeakMeterLevel, fileReport, bReportBinary);
 
         // close window by making it invisible
         setVisible(false);
@@ -60,6 +60,8 @@ private:
     ToggleButton *ButtonDumpCSV;
     ToggleButton *ButtonDumpAverageMeterLevel;
     ToggleButton *ButtonDumpPeakMeterLevel;
+    ToggleButton *ButtonDumpToFile;
+    ToggleButton *ButtonDumpBinary;
 };
 
 